@@ -0,0 +1,53 @@
+#include "allocator_the_aligned.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// A SIMD-friendly kernel through data(): with AlignedVectorTheSerene the
+// compiler knows the buffer is 64-byte aligned and padded to whole lanes,
+// so it needs no peeling loop for alignment
+
+template <typename Vector> static void BM_Saxpy(benchmark::State &state) {
+    size_t n = size_t(state.range(0));
+    Vector x(n, 1.0f);
+    Vector y(n, 2.0f);
+    for (auto _ : state) {
+        float *__restrict yd = y.data();
+        const float *__restrict xd = x.data();
+        for (size_t i = 0; i < n; ++i) {
+            yd[i] += 0.5f * xd[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations() * n * 3 *
+                                    sizeof(float)));
+}
+
+// Random reads over a buffer much bigger than the TLB covers with 4 KiB
+// pages
+static void BM_RandomGather(benchmark::State &state) {
+    constexpr size_t n = size_t(1) << 26; // 256 MiB of uint32_t
+    size_t threshold = state.range(0)
+                           ? size_t(1) << 20
+                           : AllocatorTheAligned<uint32_t>::no_huge_pages;
+    AlignedVectorTheSerene<uint32_t> v(
+        (AllocatorTheAligned<uint32_t>(threshold)));
+    v.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = uint32_t(i);
+    }
+    uint64_t index = 1;
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (int i = 0; i < 1 << 16; ++i) {
+            index = index * 6364136223846793005u + 1442695040888963407u;
+            sum += v[(index >> 20) & (n - 1)];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetLabel(state.range(0) ? "huge pages" : "4 KiB pages");
+}
+
+BENCHMARK(BM_Saxpy<VectorTheSerene<float>>)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_Saxpy<AlignedVectorTheSerene<float>>)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_RandomGather)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,19 @@
+#include "./alloc_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+void *operator new(size_t size) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    AllocCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return ::operator new(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
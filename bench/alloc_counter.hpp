@@ -0,0 +1,24 @@
+#ifndef BENCH_ALLOC_COUNTER_HPP_
+#define BENCH_ALLOC_COUNTER_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+// Counts calls to the global operator new (replaced in alloc_counter.cpp), so
+// benchmarks can report allocations next to timings
+struct AllocCounter {
+    static inline std::atomic<size_t> allocations{0};
+    static inline std::atomic<size_t> bytes{0};
+
+    size_t start_allocations = allocations.load(std::memory_order_relaxed);
+    size_t start_bytes = bytes.load(std::memory_order_relaxed);
+
+    size_t allocations_since() const {
+        return allocations.load(std::memory_order_relaxed) - start_allocations;
+    }
+    size_t bytes_since() const {
+        return bytes.load(std::memory_order_relaxed) - start_bytes;
+    }
+};
+
+#endif // BENCH_ALLOC_COUNTER_HPP_
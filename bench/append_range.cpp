@@ -0,0 +1,76 @@
+#include "vector_the_serene.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+// Ingestion: appending batches of records, one call per batch
+
+struct Record {
+    uint64_t id;
+    uint32_t kind;
+    float value;
+};
+
+template <typename T> static T make(size_t i);
+template <> Record make<Record>(size_t i) {
+    return {i, uint32_t(i % 7), float(i)};
+}
+template <> std::string make<std::string>(size_t i) {
+    return std::string(24, char('a' + i % 26));
+}
+
+template <typename T> static void BM_AppendBackInserter(benchmark::State &state) {
+    std::vector<T> batch;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        batch.push_back(make<T>(size_t(i)));
+    }
+    for (auto _ : state) {
+        VectorTheSerene<T> v;
+        for (int b = 0; b < 16; ++b) {
+            std::copy(batch.begin(), batch.end(), std::back_inserter(v));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * 16 * state.range(0));
+}
+
+template <typename T> static void BM_AppendRange(benchmark::State &state) {
+    std::vector<T> batch;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        batch.push_back(make<T>(size_t(i)));
+    }
+    for (auto _ : state) {
+        VectorTheSerene<T> v;
+        for (int b = 0; b < 16; ++b) {
+            v.append_range(batch);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * 16 * state.range(0));
+}
+
+// Sized but not contiguous: one growth, element-wise copies
+template <typename T> static void BM_AppendRangeList(benchmark::State &state) {
+    std::list<T> batch;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        batch.push_back(make<T>(size_t(i)));
+    }
+    for (auto _ : state) {
+        VectorTheSerene<T> v;
+        for (int b = 0; b < 16; ++b) {
+            v.append_range(batch);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * 16 * state.range(0));
+}
+
+BENCHMARK(BM_AppendBackInserter<Record>)->Arg(64)->Arg(4096);
+BENCHMARK(BM_AppendRange<Record>)->Arg(64)->Arg(4096);
+BENCHMARK(BM_AppendRangeList<Record>)->Arg(64)->Arg(4096);
+BENCHMARK(BM_AppendBackInserter<std::string>)->Arg(64)->Arg(4096);
+BENCHMARK(BM_AppendRange<std::string>)->Arg(64)->Arg(4096);
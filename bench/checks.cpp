@@ -0,0 +1,42 @@
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Inner loops that call back() and operator[]: compare builds with
+// different SERENE_CHECK_LEVEL values (see serene_checks.hpp). The
+// throwing back() keeps an exception path in the loop; the unchecked one
+// compiles to a plain load.
+
+static void BM_RunningMaxBack(benchmark::State &state) {
+    VectorTheSerene<int64_t> input;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        input.push_back((i * 7919) % 1000);
+    }
+    VectorTheSerene<int64_t> maxima;
+    maxima.reserve(input.size());
+    for (auto _ : state) {
+        maxima.clear();
+        maxima.push_back(input[0]);
+        for (size_t i = 1; i < input.size(); ++i) {
+            int64_t last = maxima.back();
+            maxima.push_back(input[i] > last ? input[i] : last);
+        }
+        benchmark::DoNotOptimize(maxima.back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_IndexedSum(benchmark::State &state) {
+    VectorTheSerene<int32_t> v(size_t(state.range(0)), 1);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            sum += v[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_RunningMaxBack)->Arg(1 << 16);
+BENCHMARK(BM_IndexedSum)->Arg(1 << 16);
@@ -0,0 +1,53 @@
+#include "array_the_steadfast.hpp"
+#include "vector_the_serene.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Sorting and deduplicating many short keys: dominated by == and <=>
+
+template <typename Vector> static std::vector<Vector> make_keys(size_t length) {
+    std::vector<Vector> keys(256);
+    for (size_t k = 0; k < keys.size(); ++k) {
+        for (size_t i = 0; i < length; ++i) {
+            // Keys share a long common prefix and differ near the end
+            keys[k].push_back(typename Vector::value_type(
+                i + 1 < length ? i : k));
+        }
+    }
+    return keys;
+}
+
+template <typename Vector> static void BM_KeyCompare(benchmark::State &state) {
+    auto keys = make_keys<Vector>(size_t(state.range(0)));
+    for (auto _ : state) {
+        size_t less = 0;
+        for (size_t a = 0; a < keys.size(); ++a) {
+            for (size_t b = a; b < keys.size(); b += 7) {
+                less += (keys[a] <=> keys[b]) < 0;
+                less += keys[a] == keys[b];
+            }
+        }
+        benchmark::DoNotOptimize(less);
+    }
+}
+
+BENCHMARK(BM_KeyCompare<VectorTheSerene<uint8_t>>)->RangeMultiplier(4)->Range(
+    4, 1024);
+BENCHMARK(BM_KeyCompare<VectorTheSerene<uint32_t>>)->RangeMultiplier(4)->Range(
+    4, 1024);
+BENCHMARK(BM_KeyCompare<std::vector<uint32_t>>)->RangeMultiplier(4)->Range(
+    4, 1024);
+
+template <typename Array> static void BM_ArrayEqual(benchmark::State &state) {
+    Array a{};
+    Array b{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a == b);
+    }
+}
+
+BENCHMARK(BM_ArrayEqual<ArrayTheSteadfast<uint64_t, 64>>);
+BENCHMARK(BM_ArrayEqual<std::array<uint64_t, 64>>);
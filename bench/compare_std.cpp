@@ -0,0 +1,271 @@
+#include "array_the_steadfast.hpp"
+#include "vector_the_serene.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <compare>
+#include <string>
+#include <vector>
+
+// VectorTheSerene and ArrayTheSteadfast against std::vector and std::array,
+// for the regression gate. Run with
+//   bench_vector --benchmark_filter=Compare --benchmark_out=results.json
+//   --benchmark_out_format=json
+// or build the run_benchmarks target.
+
+namespace {
+
+struct LargeStruct {
+    uint64_t fields[16];
+
+    LargeStruct(uint64_t seed = 0) {
+        for (auto &field : fields) {
+            field = seed++;
+        }
+    }
+
+    bool operator==(const LargeStruct &other) const = default;
+    auto operator<=>(const LargeStruct &other) const = default;
+};
+
+template <typename T> T make_value(size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        // Long enough to avoid the small string optimization
+        return std::string(32, char('a' + i % 26));
+    } else {
+        return T(i);
+    }
+}
+
+template <typename Vector> Vector make_filled(size_t n) {
+    Vector v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(make_value<typename Vector::value_type>(i));
+    }
+    return v;
+}
+
+template <typename Vector> void BM_Compare_PushBack(benchmark::State &state) {
+    using T = typename Vector::value_type;
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(make_value<T>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_EmplaceBack(benchmark::State &state) {
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (std::is_same_v<typename Vector::value_type,
+                                         std::string>) {
+                v.emplace_back(size_t(32), char('a' + i % 26));
+            } else {
+                v.emplace_back(i);
+            }
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_ReserveFill(benchmark::State &state) {
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        auto v = make_filled<Vector>(n);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_InsertFront(benchmark::State &state) {
+    using T = typename Vector::value_type;
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            v.insert(v.begin(), make_value<T>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_InsertMiddle(benchmark::State &state) {
+    using T = typename Vector::value_type;
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            v.insert(v.begin() + v.size() / 2, make_value<T>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_EraseRange(benchmark::State &state) {
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = make_filled<Vector>(n);
+        state.ResumeTiming();
+        // Drop the middle half
+        v.erase(v.begin() + n / 4, v.begin() + n / 4 * 3);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector> void BM_Compare_Copy(benchmark::State &state) {
+    auto source = make_filled<Vector>(state.range(0));
+    for (auto _ : state) {
+        Vector copy(source);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vector> void BM_Compare_Move(benchmark::State &state) {
+    auto a = make_filled<Vector>(state.range(0));
+    for (auto _ : state) {
+        Vector b(std::move(a));
+        a = std::move(b);
+        benchmark::DoNotOptimize(a.begin());
+    }
+}
+
+template <typename Vector> void BM_Compare_Clear(benchmark::State &state) {
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto v = make_filled<Vector>(n);
+        state.ResumeTiming();
+        v.clear();
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vector>
+void BM_Compare_ThreeWay(benchmark::State &state) {
+    auto a = make_filled<Vector>(state.range(0));
+    auto b = a;
+    for (auto _ : state) {
+        auto result = a <=> b;
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Array> void BM_Compare_ArrayFill(benchmark::State &state) {
+    using T = typename Array::value_type;
+    Array a{};
+    T value = make_value<T>(7);
+    for (auto _ : state) {
+        for (auto &item : a) {
+            item = value;
+        }
+        benchmark::DoNotOptimize(a.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+template <typename Array> void BM_Compare_ArrayCopy(benchmark::State &state) {
+    Array a{};
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = make_value<typename Array::value_type>(i);
+    }
+    for (auto _ : state) {
+        Array copy(a);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+template <typename Array> void BM_Compare_ArraySwap(benchmark::State &state) {
+    Array a{};
+    Array b{};
+    for (auto _ : state) {
+        a.swap(b);
+        benchmark::DoNotOptimize(a.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+template <typename Array>
+void BM_Compare_ArrayThreeWay(benchmark::State &state) {
+    Array a{};
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = make_value<typename Array::value_type>(i);
+    }
+    Array b(a);
+    for (auto _ : state) {
+        auto result = a <=> b;
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+} // namespace
+
+#define COMPARE_VECTOR_BENCHMARKS(Vector)                                      \
+    BENCHMARK(BM_Compare_PushBack<Vector>)                                     \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15);                                                   \
+    BENCHMARK(BM_Compare_EmplaceBack<Vector>)                                  \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15);                                                   \
+    BENCHMARK(BM_Compare_ReserveFill<Vector>)                                  \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15);                                                   \
+    BENCHMARK(BM_Compare_InsertFront<Vector>)                                  \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 12);                                                   \
+    BENCHMARK(BM_Compare_InsertMiddle<Vector>)                                 \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 12);                                                   \
+    BENCHMARK(BM_Compare_EraseRange<Vector>)                                   \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15);                                                   \
+    BENCHMARK(BM_Compare_Copy<Vector>)->RangeMultiplier(8)->Range(8, 1 << 15); \
+    BENCHMARK(BM_Compare_Move<Vector>)->Arg(1 << 10);                          \
+    BENCHMARK(BM_Compare_Clear<Vector>)                                        \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15);                                                   \
+    BENCHMARK(BM_Compare_ThreeWay<Vector>)                                     \
+        ->RangeMultiplier(8)                                                   \
+        ->Range(8, 1 << 15)
+
+#define COMPARE_ARRAY_BENCHMARKS(...)                                          \
+    BENCHMARK(BM_Compare_ArrayFill<__VA_ARGS__>);                              \
+    BENCHMARK(BM_Compare_ArrayCopy<__VA_ARGS__>);                              \
+    BENCHMARK(BM_Compare_ArraySwap<__VA_ARGS__>);                              \
+    BENCHMARK(BM_Compare_ArrayThreeWay<__VA_ARGS__>)
+
+COMPARE_VECTOR_BENCHMARKS(VectorTheSerene<int>);
+COMPARE_VECTOR_BENCHMARKS(std::vector<int>);
+COMPARE_VECTOR_BENCHMARKS(VectorTheSerene<std::string>);
+COMPARE_VECTOR_BENCHMARKS(std::vector<std::string>);
+COMPARE_VECTOR_BENCHMARKS(VectorTheSerene<LargeStruct>);
+COMPARE_VECTOR_BENCHMARKS(std::vector<LargeStruct>);
+
+COMPARE_ARRAY_BENCHMARKS(ArrayTheSteadfast<int, 16>);
+COMPARE_ARRAY_BENCHMARKS(std::array<int, 16>);
+COMPARE_ARRAY_BENCHMARKS(ArrayTheSteadfast<int, 4096>);
+COMPARE_ARRAY_BENCHMARKS(std::array<int, 4096>);
+COMPARE_ARRAY_BENCHMARKS(ArrayTheSteadfast<std::string, 64>);
+COMPARE_ARRAY_BENCHMARKS(std::array<std::string, 64>);
+COMPARE_ARRAY_BENCHMARKS(ArrayTheSteadfast<LargeStruct, 64>);
+COMPARE_ARRAY_BENCHMARKS(std::array<LargeStruct, 64>);
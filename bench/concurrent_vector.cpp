@@ -0,0 +1,67 @@
+#include "concurrent_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Many threads appending events to one shared vector. The vectors are
+// created once per run by Setup, before the threads start, and keep growing
+// over a fixed number of iterations.
+
+struct Event {
+    uint64_t timestamp;
+    uint32_t source;
+    uint32_t kind;
+};
+
+static constexpr int kEventsPerThread = 1 << 14;
+static constexpr int kIterations = 50;
+
+static std::unique_ptr<VectorTheSerene<Event>> locked_events;
+static std::mutex locked_events_mutex;
+static std::unique_ptr<ConcurrentVectorTheSerene<Event>> concurrent_events;
+
+static void create_vectors(const benchmark::State &) {
+    locked_events = std::make_unique<VectorTheSerene<Event>>();
+    concurrent_events = std::make_unique<ConcurrentVectorTheSerene<Event>>();
+}
+
+static void destroy_vectors(const benchmark::State &) {
+    locked_events.reset();
+    concurrent_events.reset();
+}
+
+static void BM_AppendMutexVector(benchmark::State &state) {
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerThread; ++i) {
+            std::lock_guard lock(locked_events_mutex);
+            locked_events->push_back(
+                {uint64_t(i), uint32_t(state.thread_index()), 0});
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerThread);
+}
+
+static void BM_AppendConcurrentVector(benchmark::State &state) {
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerThread; ++i) {
+            concurrent_events->push_back(
+                {uint64_t(i), uint32_t(state.thread_index()), 0});
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerThread);
+}
+
+BENCHMARK(BM_AppendMutexVector)
+    ->Setup(create_vectors)
+    ->Teardown(destroy_vectors)
+    ->Iterations(kIterations)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK(BM_AppendConcurrentVector)
+    ->Setup(create_vectors)
+    ->Teardown(destroy_vectors)
+    ->Iterations(kIterations)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
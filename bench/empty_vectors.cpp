@@ -0,0 +1,53 @@
+#include "./alloc_counter.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Constructs and destroys a vector of n empty rows. "Eager" reproduces the old
+// default constructor, which allocated 16 elements for every empty vector.
+
+static void report_allocations(benchmark::State &state,
+                               const AllocCounter &counter) {
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+        double(counter.allocations_since()), benchmark::Counter::kAvgIterations);
+    state.counters["bytes_per_iter"] = benchmark::Counter(
+        double(counter.bytes_since()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_EmptyRows_Lazy(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        VectorTheSerene<VectorTheSerene<int>> rows;
+        rows.resize(state.range(0));
+        benchmark::DoNotOptimize(rows.begin());
+    }
+    report_allocations(state, counter);
+}
+
+static void BM_EmptyRows_Eager(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        VectorTheSerene<VectorTheSerene<int>> rows;
+        rows.resize(state.range(0));
+        for (auto &row : rows) {
+            row.reserve(16);
+        }
+        benchmark::DoNotOptimize(rows.begin());
+    }
+    report_allocations(state, counter);
+}
+
+static void BM_EmptyRows_StdVector(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        std::vector<std::vector<int>> rows;
+        rows.resize(state.range(0));
+        benchmark::DoNotOptimize(rows.data());
+    }
+    report_allocations(state, counter);
+}
+
+BENCHMARK(BM_EmptyRows_Lazy)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_EmptyRows_Eager)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_EmptyRows_StdVector)->Range(1 << 10, 1 << 20);
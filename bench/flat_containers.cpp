@@ -0,0 +1,122 @@
+#include "flat_map_the_serene.hpp"
+#include "flat_set_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Ordered lookup tables: node-based std::set/std::map against the sorted
+// flat containers, in both layouts
+
+using EytzingerSet =
+    FlatSetTheSerene<int64_t, std::less<int64_t>, FlatLayout::eytzinger>;
+using EytzingerMap = FlatMapTheSerene<int64_t, int64_t, std::less<int64_t>,
+                                      FlatLayout::eytzinger>;
+
+static std::vector<int64_t> random_keys(int64_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<int64_t> keys(n);
+    for (auto &key : keys) {
+        key = int64_t(rng() % uint64_t(4 * n));
+    }
+    return keys;
+}
+
+static std::vector<std::pair<int64_t, int64_t>> random_pairs(int64_t n) {
+    std::vector<std::pair<int64_t, int64_t>> pairs;
+    for (int64_t key : random_keys(n, 1)) {
+        pairs.emplace_back(key, key);
+    }
+    return pairs;
+}
+
+template <typename Set> static void BM_SetLookup(benchmark::State &state) {
+    auto keys = random_keys(state.range(0), 1);
+    Set set(keys);
+    // Half of the probes miss
+    auto probes = random_keys(state.range(0), 2);
+    for (auto _ : state) {
+        int64_t found = 0;
+        for (int64_t probe : probes) {
+            found += set.contains(probe);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename Map> static void BM_MapLookup(benchmark::State &state) {
+    auto pairs = random_pairs(state.range(0));
+    Map map(pairs);
+    auto probes = random_keys(state.range(0), 2);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int64_t probe : probes) {
+            auto it = map.find(probe);
+            if (it != map.end()) {
+                sum += it->second;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename Set> static void BM_SetBulkBuild(benchmark::State &state) {
+    auto keys = random_keys(state.range(0), 1);
+    for (auto _ : state) {
+        Set set(keys);
+        benchmark::DoNotOptimize(set.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map> static void BM_MapBulkBuild(benchmark::State &state) {
+    auto pairs = random_pairs(state.range(0));
+    for (auto _ : state) {
+        Map map(pairs);
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+
+// The flat set built one key at a time, for comparison with the bulk build
+static void BM_FlatSetSingleInserts(benchmark::State &state) {
+    auto keys = random_keys(state.range(0), 1);
+    for (auto _ : state) {
+        FlatSetTheSerene<int64_t> set;
+        for (int64_t key : keys) {
+            set.insert(key);
+        }
+        benchmark::DoNotOptimize(set.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// std::set has no range constructor taking a range object directly
+template <typename T> struct StdSet : std::set<T> {
+    explicit StdSet(const std::vector<T> &items)
+        : std::set<T>(items.begin(), items.end()) {}
+};
+template <typename K, typename V> struct StdMap : std::map<K, V> {
+    explicit StdMap(const std::vector<std::pair<K, V>> &items)
+        : std::map<K, V>(items.begin(), items.end()) {}
+};
+
+BENCHMARK(BM_SetLookup<StdSet<int64_t>>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_SetLookup<FlatSetTheSerene<int64_t>>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_SetLookup<EytzingerSet>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_MapLookup<StdMap<int64_t, int64_t>>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_MapLookup<FlatMapTheSerene<int64_t, int64_t>>)
+    ->Arg(1 << 10)
+    ->Arg(1 << 20);
+BENCHMARK(BM_MapLookup<EytzingerMap>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_SetBulkBuild<StdSet<int64_t>>)->Arg(1 << 20);
+BENCHMARK(BM_SetBulkBuild<FlatSetTheSerene<int64_t>>)->Arg(1 << 20);
+BENCHMARK(BM_SetBulkBuild<EytzingerSet>)->Arg(1 << 20);
+BENCHMARK(BM_MapBulkBuild<StdMap<int64_t, int64_t>>)->Arg(1 << 20);
+BENCHMARK(BM_MapBulkBuild<FlatMapTheSerene<int64_t, int64_t>>)->Arg(1 << 20);
+BENCHMARK(BM_FlatSetSingleInserts)->Arg(1 << 14);
@@ -0,0 +1,81 @@
+#include "./alloc_counter.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// push_back traces under each growth policy. Besides the throughput, reports
+// the number of reallocations and the memory overhead (unused capacity
+// relative to the size), both at the end of the trace and averaged over
+// every step of it.
+
+template <typename Policy>
+static void BM_PushBackTrace(benchmark::State &state) {
+    using Vector = VectorTheSerene<int, std::allocator<int>, Policy>;
+    size_t n = state.range(0);
+    AllocCounter counter;
+    double final_overhead = 0;
+    double mean_overhead = 0;
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(int(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+        final_overhead = double(v.capacity() - v.size()) / double(v.size());
+    }
+    state.counters["reallocs"] = benchmark::Counter(
+        double(counter.allocations_since()), benchmark::Counter::kAvgIterations);
+    state.counters["final_overhead"] = final_overhead;
+
+    // The mean overhead doesn't depend on timing, so compute it once
+    Vector v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(int(i));
+        mean_overhead += double(v.capacity() - v.size()) / double(v.size());
+    }
+    state.counters["mean_overhead"] = mean_overhead / double(n);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Many vectors with random, mostly small sizes, as in per-request lists
+template <typename Policy>
+static void BM_RandomSizesTrace(benchmark::State &state) {
+    using Vector = VectorTheSerene<int, std::allocator<int>, Policy>;
+    std::mt19937 rng(1);
+    std::geometric_distribution<size_t> sizes(1.0 / double(state.range(0)));
+    std::vector<size_t> trace(1024);
+    for (auto &size : trace) {
+        size = sizes(rng) + 1;
+    }
+    size_t pushed = 0;
+    size_t unused = 0;
+    for (auto _ : state) {
+        unused = 0;
+        for (auto size : trace) {
+            Vector v;
+            for (size_t i = 0; i < size; ++i) {
+                v.push_back(int(i));
+            }
+            benchmark::DoNotOptimize(v.begin());
+            unused += v.capacity() - v.size();
+            pushed += size;
+        }
+    }
+    size_t total = 0;
+    for (auto size : trace) {
+        total += size;
+    }
+    state.counters["mean_overhead"] = double(unused) / double(total);
+    state.SetItemsProcessed(int64_t(pushed));
+}
+
+#define GROWTH_BENCHMARKS(Policy)                                              \
+    BENCHMARK(BM_PushBackTrace<Policy>)->Range(1 << 10, 1 << 20);              \
+    BENCHMARK(BM_RandomSizesTrace<Policy>)->Arg(4)->Arg(64)->Arg(1024)
+
+GROWTH_BENCHMARKS(DoublingGrowth<>);
+GROWTH_BENCHMARKS(OneAndHalfGrowth<>);
+GROWTH_BENCHMARKS(GoldenRatioGrowth<>);
+GROWTH_BENCHMARKS(SizeClassGrowth<>);
+GROWTH_BENCHMARKS(SizeClassGrowth<4>);
+GROWTH_BENCHMARKS(FixedIncrementGrowth<4096>);
@@ -0,0 +1,104 @@
+#include "hash_map_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Symbol tables: short string keys looked up far more often than inserted,
+// plus integer keys and a churn of inserts and erases
+
+static std::vector<std::string> symbols(int64_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> names;
+    names.reserve(n);
+    for (int64_t i = 0; i < n; ++i) {
+        names.push_back("symbol_" + std::to_string(rng() % uint64_t(2 * n)));
+    }
+    return names;
+}
+
+static std::vector<int64_t> integers(int64_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<int64_t> keys(n);
+    for (auto &key : keys) {
+        key = int64_t(rng() % uint64_t(2 * n));
+    }
+    return keys;
+}
+
+template <typename Map, typename Key>
+static void lookups(benchmark::State &state, const std::vector<Key> &keys,
+                    const std::vector<Key> &probes) {
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map[keys[i]] = int64_t(i);
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        // About half of the probes miss
+        for (const auto &probe : probes) {
+            auto it = map.find(probe);
+            if (it != map.end()) {
+                sum += it->second;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename Map> static void BM_SymbolLookup(benchmark::State &state) {
+    lookups<Map>(state, symbols(state.range(0), 1), symbols(state.range(0), 2));
+}
+
+template <typename Map> static void BM_IntLookup(benchmark::State &state) {
+    lookups<Map>(state, integers(state.range(0), 1),
+                 integers(state.range(0), 2));
+}
+
+template <typename Map> static void BM_IntInsert(benchmark::State &state) {
+    auto keys = integers(state.range(0), 1);
+    for (auto _ : state) {
+        Map map;
+        map.reserve(keys.size());
+        for (int64_t key : keys) {
+            map[key] = key;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// Inserts and erases in a table of steady size: tombstone-based tables
+// slow down here, backward-shift deletion keeps the probe runs short
+template <typename Map> static void BM_IntChurn(benchmark::State &state) {
+    auto keys = integers(4 * state.range(0), 1);
+    Map map;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        map[keys[i]] = i;
+    }
+    for (auto _ : state) {
+        for (size_t i = state.range(0); i < keys.size(); ++i) {
+            map.erase(keys[i - state.range(0)]);
+            map[keys[i]] = int64_t(i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * 3 * state.range(0));
+}
+
+using StdSymbols = std::unordered_map<std::string, int64_t>;
+using SereneSymbols = HashMapTheSerene<std::string, int64_t>;
+using StdInts = std::unordered_map<int64_t, int64_t>;
+using SereneInts = HashMapTheSerene<int64_t, int64_t>;
+
+BENCHMARK(BM_SymbolLookup<StdSymbols>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_SymbolLookup<SereneSymbols>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_IntLookup<StdInts>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_IntLookup<SereneInts>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_IntInsert<StdInts>)->Arg(1 << 20);
+BENCHMARK(BM_IntInsert<SereneInts>)->Arg(1 << 20);
+BENCHMARK(BM_IntChurn<StdInts>)->Arg(1 << 16);
+BENCHMARK(BM_IntChurn<SereneInts>)->Arg(1 << 16);
@@ -0,0 +1,81 @@
+#include "./alloc_counter.hpp"
+#include "jagged_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Adjacency lists of a graph with 1 Mi nodes and a few edges each
+
+static constexpr uint32_t kNodes = 1 << 20;
+
+static uint32_t degree(uint32_t node) { return node * 2654435761u >> 29; }
+
+static void BM_AdjacencyBuildNested(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        VectorTheSerene<VectorTheSerene<uint32_t>> graph;
+        for (uint32_t node = 0; node < kNodes; ++node) {
+            auto &edges = graph.emplace_back();
+            for (uint32_t e = 0; e < degree(node); ++e) {
+                edges.push_back(node ^ e);
+            }
+        }
+        benchmark::DoNotOptimize(graph.begin());
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        double(counter.allocations_since()), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_AdjacencyBuildJagged(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        JaggedVectorTheSerene<uint32_t> graph;
+        for (uint32_t node = 0; node < kNodes; ++node) {
+            graph.push_row();
+            for (uint32_t e = 0; e < degree(node); ++e) {
+                graph.push_to_last_row(node ^ e);
+            }
+        }
+        benchmark::DoNotOptimize(graph.begin());
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        double(counter.allocations_since()), benchmark::Counter::kAvgIterations);
+}
+
+template <typename Graph> static Graph build() {
+    Graph graph;
+    for (uint32_t node = 0; node < kNodes; ++node) {
+        if constexpr (std::is_same_v<Graph, JaggedVectorTheSerene<uint32_t>>) {
+            graph.push_row();
+            for (uint32_t e = 0; e < degree(node); ++e) {
+                graph.push_to_last_row(node ^ e);
+            }
+        } else {
+            auto &edges = graph.emplace_back();
+            for (uint32_t e = 0; e < degree(node); ++e) {
+                edges.push_back(node ^ e);
+            }
+        }
+    }
+    return graph;
+}
+
+template <typename Graph> static void BM_AdjacencyScan(benchmark::State &state) {
+    auto graph = build<Graph>();
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (const auto &edges : graph) {
+            for (uint32_t to : edges) {
+                sum += to;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_AdjacencyBuildNested)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AdjacencyBuildJagged)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AdjacencyScan<VectorTheSerene<VectorTheSerene<uint32_t>>>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AdjacencyScan<JaggedVectorTheSerene<uint32_t>>)
+    ->Unit(benchmark::kMillisecond);
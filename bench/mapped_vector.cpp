@@ -0,0 +1,58 @@
+#include "mapped_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifdef __unix__
+
+// Startup: loading a file of 16 Mi fixed-size records and looking at a few
+
+struct Record {
+    uint64_t id;
+    uint64_t payload[3];
+};
+
+static constexpr size_t kRecords = size_t(1) << 24;
+
+static const std::string &records_file() {
+    static const std::string path = [] {
+        std::string name = "/tmp/bench_mapped_records.bin";
+        MappedVectorTheSerene<Record> file(name, MapMode::truncate);
+        file.reserve(kRecords);
+        for (uint64_t i = 0; i < kRecords; ++i) {
+            file.push_back({i, {i, i, i}});
+        }
+        return name;
+    }();
+    return path;
+}
+
+static void BM_LoadByReading(benchmark::State &state) {
+    const auto &path = records_file();
+    for (auto _ : state) {
+        std::ifstream in(path, std::ios::binary);
+        VectorTheSerene<Record> records;
+        Record record;
+        while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+            records.push_back(record);
+        }
+        benchmark::DoNotOptimize(records[records.size() / 2].id);
+    }
+}
+
+static void BM_LoadMapped(benchmark::State &state) {
+    const auto &path = records_file();
+    for (auto _ : state) {
+        MappedVectorTheSerene<Record> records(path, MapMode::read_only);
+        records.advise(MapAccess::random);
+        benchmark::DoNotOptimize(records[records.size() / 2].id);
+    }
+}
+
+BENCHMARK(BM_LoadByReading)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadMapped)->Unit(benchmark::kMillisecond);
+
+#endif
@@ -0,0 +1,96 @@
+#include "parallel_the_swift.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+// Bulk operations on a 64 Mi element buffer with 1..N threads
+
+static constexpr size_t kElements = size_t(1) << 26;
+
+static void thread_counts(benchmark::internal::Benchmark *bench) {
+    unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        bench->Arg(threads);
+    }
+    bench->Arg(cores);
+}
+
+static ParallelOptions options_for(const benchmark::State &state,
+                                   std::unique_ptr<ThreadPoolTheSwift> &pool) {
+    pool = std::make_unique<ThreadPoolTheSwift>(size_t(state.range(0)));
+    return {pool.get(), 0};
+}
+
+static void BM_ParallelFill(benchmark::State &state) {
+    std::unique_ptr<ThreadPoolTheSwift> pool;
+    auto options = options_for(state, pool);
+    VectorTheSerene<uint32_t> v(kElements, 0);
+    uint32_t value = 0;
+    for (auto _ : state) {
+        parallel_fill(v, ++value, options);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * kElements * sizeof(uint32_t));
+}
+
+static void BM_ParallelResize(benchmark::State &state) {
+    std::unique_ptr<ThreadPoolTheSwift> pool;
+    auto options = options_for(state, pool);
+    VectorTheSerene<uint32_t> v;
+    v.reserve(kElements);
+    for (auto _ : state) {
+        v.clear();
+        parallel_resize(v, kElements, 7u, options);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * kElements * sizeof(uint32_t));
+}
+
+static void BM_ParallelTransform(benchmark::State &state) {
+    std::unique_ptr<ThreadPoolTheSwift> pool;
+    auto options = options_for(state, pool);
+    VectorTheSerene<uint32_t> v(kElements, 1);
+    for (auto _ : state) {
+        parallel_transform(v, v.begin(),
+                           [](uint32_t x) { return x * 2654435761u + 1; },
+                           options);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * kElements * sizeof(uint32_t));
+}
+
+static void BM_ParallelReduce(benchmark::State &state) {
+    std::unique_ptr<ThreadPoolTheSwift> pool;
+    auto options = options_for(state, pool);
+    VectorTheSerene<uint32_t> v(kElements, 3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            parallel_reduce(v, uint64_t(0), std::plus<>(), options));
+    }
+    state.SetBytesProcessed(state.iterations() * kElements * sizeof(uint32_t));
+}
+
+static void BM_ParallelSort(benchmark::State &state) {
+    std::unique_ptr<ThreadPoolTheSwift> pool;
+    auto options = options_for(state, pool);
+    VectorTheSerene<uint32_t> v(kElements / 8, 0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        parallel_for(
+            0, v.size(),
+            [&v](size_t i) { v[i] = uint32_t(i * 2654435761u); }, options);
+        state.ResumeTiming();
+        parallel_sort(v, std::less<>(), options);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+
+BENCHMARK(BM_ParallelFill)->Apply(thread_counts)->UseRealTime();
+BENCHMARK(BM_ParallelResize)->Apply(thread_counts)->UseRealTime();
+BENCHMARK(BM_ParallelTransform)->Apply(thread_counts)->UseRealTime();
+BENCHMARK(BM_ParallelReduce)->Apply(thread_counts)->UseRealTime();
+BENCHMARK(BM_ParallelSort)->Apply(thread_counts)->UseRealTime();
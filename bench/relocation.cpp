@@ -0,0 +1,70 @@
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <numeric>
+
+// Growth, front insertion and front erasure, which go through a single
+// memcpy/memmove for trivially relocatable element types
+
+template <typename T> static T make_item(size_t i) {
+    if constexpr (std::is_same_v<T, std::unique_ptr<int>>) {
+        return std::make_unique<int>(int(i));
+    } else {
+        return T(i);
+    }
+}
+
+template <typename T> static void BM_PushBackGrowth(benchmark::State &state) {
+    for (auto _ : state) {
+        VectorTheSerene<T> v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_back(make_item<T>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T> static void BM_InsertFront(benchmark::State &state) {
+    for (auto _ : state) {
+        VectorTheSerene<T> v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.insert(v.begin(), make_item<T>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T> static void BM_EraseFront(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        VectorTheSerene<T> v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_back(make_item<T>(i));
+        }
+        state.ResumeTiming();
+        while (!v.empty()) {
+            v.erase(v.begin());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same layout as int, but not trivially copyable, so it takes the element by
+// element path
+struct BoxedInt {
+    int value;
+    BoxedInt(size_t v) : value(int(v)) {}
+    BoxedInt(const BoxedInt &other) : value(other.value) {}
+    BoxedInt(BoxedInt &&other) noexcept : value(other.value) {}
+    ~BoxedInt() {}
+};
+
+BENCHMARK(BM_PushBackGrowth<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PushBackGrowth<BoxedInt>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PushBackGrowth<std::unique_ptr<int>>)->Range(1 << 10, 1 << 16);
+BENCHMARK(BM_InsertFront<int>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_InsertFront<BoxedInt>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_EraseFront<int>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_EraseFront<BoxedInt>)->Range(1 << 8, 1 << 14);
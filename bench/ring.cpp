@@ -0,0 +1,66 @@
+#include "ring_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <deque>
+
+// FIFO queues of steady length: every step dequeues the oldest element and
+// enqueues a new one. erase(begin()) on a vector shifts the whole queue.
+
+template <typename Queue> static void pop_oldest(Queue &queue) {
+    if constexpr (requires { queue.pop_front(); }) {
+        queue.pop_front();
+    } else {
+        queue.erase(queue.begin());
+    }
+}
+
+template <typename Queue> static void BM_Fifo(benchmark::State &state) {
+    Queue queue;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        queue.push_back(i);
+    }
+    int64_t next = state.range(0);
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            benchmark::DoNotOptimize(queue.front());
+            pop_oldest(queue);
+            queue.push_back(next++);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+// The last 4096 samples of a stream
+static void BM_TelemetryWindowRing(benchmark::State &state) {
+    RingTheSerene<double> window(4096, RingMode::overwrite_oldest);
+    double sample = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            window.push_back(sample += 0.5);
+        }
+        benchmark::DoNotOptimize(window.back());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+static void BM_TelemetryWindowDeque(benchmark::State &state) {
+    std::deque<double> window;
+    double sample = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            if (window.size() == 4096) {
+                window.pop_front();
+            }
+            window.push_back(sample += 0.5);
+        }
+        benchmark::DoNotOptimize(window.back());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK(BM_Fifo<VectorTheSerene<int64_t>>)->Arg(64)->Arg(1 << 14);
+BENCHMARK(BM_Fifo<std::deque<int64_t>>)->Arg(64)->Arg(1 << 14);
+BENCHMARK(BM_Fifo<RingTheSerene<int64_t>>)->Arg(64)->Arg(1 << 14);
+BENCHMARK(BM_TelemetryWindowRing);
+BENCHMARK(BM_TelemetryWindowDeque);
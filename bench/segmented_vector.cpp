@@ -0,0 +1,88 @@
+#include "segmented_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <deque>
+#include <string>
+
+// Growing queues: the worst single push_back is a full copy of the buffer
+// for VectorTheSerene, but only a block allocation for the segmented vector
+
+template <typename Vector>
+static void BM_PushBackWorstCase(benchmark::State &state) {
+    using clock = std::chrono::steady_clock;
+    double worst_ns = 0;
+    for (auto _ : state) {
+        Vector v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            auto start = clock::now();
+            v.push_back(std::to_string(i));
+            auto ns = std::chrono::duration<double, std::nano>(clock::now() -
+                                                              start)
+                          .count();
+            worst_ns = std::max(worst_ns, ns);
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.counters["worst_push_ns"] = worst_ns;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vector> static void BM_PushFront(benchmark::State &state) {
+    for (auto _ : state) {
+        Vector v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_front(int(i));
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vector>
+static void BM_IndexedScan(benchmark::State &state) {
+    Vector v;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        v.push_back(int(i));
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            sum += v[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// A queue of steady length: push_back and pop_front, many times over the
+// length. The memory held stays proportional to the length.
+template <typename Queue> static void BM_Fifo(benchmark::State &state) {
+    Queue queue;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        queue.push_back(int(i));
+    }
+    int next = int(state.range(0));
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            queue.pop_front();
+            queue.push_back(next++);
+        }
+        benchmark::DoNotOptimize(queue.front());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK(BM_PushBackWorstCase<VectorTheSerene<std::string>>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PushBackWorstCase<SegmentedVectorTheSerene<std::string>>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PushFront<SegmentedVectorTheSerene<int>>)->Arg(1 << 20);
+BENCHMARK(BM_PushFront<std::deque<int>>)->Arg(1 << 20);
+BENCHMARK(BM_IndexedScan<VectorTheSerene<int>>)->Arg(1 << 20);
+BENCHMARK(BM_IndexedScan<SegmentedVectorTheSerene<int>>)->Arg(1 << 20);
+BENCHMARK(BM_IndexedScan<std::deque<int>>)->Arg(1 << 20);
+BENCHMARK(BM_Fifo<SegmentedVectorTheSerene<int>>)->Arg(100)->Arg(1 << 16);
+BENCHMARK(BM_Fifo<std::deque<int>>)->Arg(100)->Arg(1 << 16);
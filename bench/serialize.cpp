@@ -0,0 +1,59 @@
+#include "serene_serialize.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <sstream>
+
+// Cache snapshot: a 1 Mi element vector saved and restored
+
+static VectorTheSerene<uint64_t> make_snapshot() {
+    VectorTheSerene<uint64_t> v;
+    for (uint64_t i = 0; i < (1 << 20); ++i) {
+        v.push_back(i * 2654435761u);
+    }
+    return v;
+}
+
+static void BM_SnapshotText(benchmark::State &state) {
+    auto v = make_snapshot();
+    for (auto _ : state) {
+        std::stringstream ss;
+        // What print_vector does, into a stream
+        for (size_t i = 0; i < v.size(); ++i) {
+            ss << v[i] << " ";
+        }
+        VectorTheSerene<uint64_t> restored;
+        uint64_t x;
+        while (ss >> x) {
+            restored.push_back(x);
+        }
+        benchmark::DoNotOptimize(restored.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * v.size() * 8);
+}
+
+static void BM_SnapshotBinary(benchmark::State &state) {
+    auto v = make_snapshot();
+    for (auto _ : state) {
+        auto blob = serene_serialize(v);
+        auto restored = serene_deserialize<VectorTheSerene<uint64_t>>(
+            blob.begin(), blob.size());
+        benchmark::DoNotOptimize(restored.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * v.size() * 8);
+}
+
+static void BM_SnapshotView(benchmark::State &state) {
+    auto v = make_snapshot();
+    auto blob = serene_serialize(v);
+    for (auto _ : state) {
+        auto view = serene_view<uint64_t>(blob.begin(), blob.size(),
+                                          state.range(0) != 0);
+        benchmark::DoNotOptimize(view.data());
+    }
+    state.SetBytesProcessed(state.iterations() * v.size() * 8);
+}
+
+BENCHMARK(BM_SnapshotText)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotBinary)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotView)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
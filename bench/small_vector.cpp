@@ -0,0 +1,30 @@
+#include "./alloc_counter.hpp"
+#include "static_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+
+// Per-packet metadata lists: many short-lived vectors of a few elements
+
+template <typename Vector> static void BM_ShortLists(benchmark::State &state) {
+    AllocCounter counter;
+    for (auto _ : state) {
+        for (int packet = 0; packet < 1024; ++packet) {
+            Vector v;
+            for (int64_t i = 0; i < state.range(0); ++i) {
+                v.push_back(uint32_t(packet + i));
+            }
+            benchmark::DoNotOptimize(v.begin());
+        }
+    }
+    state.counters["allocs_per_list"] =
+        benchmark::Counter(double(counter.allocations_since()) / 1024,
+                           benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK(BM_ShortLists<VectorTheSerene<uint32_t>>)->DenseRange(0, 12, 4);
+BENCHMARK(BM_ShortLists<SmallVectorTheSerene<uint32_t, 8>>)
+    ->DenseRange(0, 12, 4);
+// Never allocates, even past 8 elements
+BENCHMARK(BM_ShortLists<StaticVectorTheSerene<uint32_t, 16>>)
+    ->DenseRange(0, 12, 4);
@@ -0,0 +1,116 @@
+#include "soa_vector_the_serene.hpp"
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// An 8-field record of which the hot loop reads only one or two fields
+
+struct Particle {
+    uint64_t id;
+    double x, y, z;
+    double vx, vy, vz;
+    float mass;
+};
+
+using ParticleColumns = SoaVectorTheSerene<uint64_t, double, double, double,
+                                           double, double, double, float>;
+
+static constexpr size_t kParticles = 1 << 20;
+
+static VectorTheSerene<Particle> build_aos() {
+    VectorTheSerene<Particle> particles;
+    for (size_t i = 0; i < kParticles; ++i) {
+        double d = double(i);
+        particles.push_back({i, d, d + 1, d + 2, 0.5, 0.25, 0.125, 1.0f});
+    }
+    return particles;
+}
+
+static ParticleColumns build_soa() {
+    ParticleColumns particles;
+    for (size_t i = 0; i < kParticles; ++i) {
+        double d = double(i);
+        particles.push_back(i, d, d + 1, d + 2, 0.5, 0.25, 0.125, 1.0f);
+    }
+    return particles;
+}
+
+static void BM_SumOneFieldAoS(benchmark::State &state) {
+    auto particles = build_aos();
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto &p : particles) {
+            sum += p.x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations() * kParticles *
+                                    sizeof(double)));
+}
+
+static void BM_SumOneFieldSoA(benchmark::State &state) {
+    auto particles = build_soa();
+    for (auto _ : state) {
+        double sum = 0;
+        for (double x : particles.column<1>()) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations() * kParticles *
+                                    sizeof(double)));
+}
+
+// x += vx for every particle
+static void BM_UpdateAoS(benchmark::State &state) {
+    auto particles = build_aos();
+    for (auto _ : state) {
+        for (auto &p : particles) {
+            p.x += p.vx;
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+static void BM_UpdateSoA(benchmark::State &state) {
+    auto particles = build_soa();
+    for (auto _ : state) {
+        double *x = particles.data<1>();
+        const double *vx = particles.data<4>();
+        for (size_t i = 0; i < particles.size(); ++i) {
+            x[i] += vx[i];
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+// Row-wise access through the proxy references, for comparison
+static void BM_UpdateSoARows(benchmark::State &state) {
+    auto particles = build_soa();
+    for (auto _ : state) {
+        for (auto [id, x, y, z, vx, vy, vz, mass] : particles) {
+            x += vx;
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+static void BM_PushBackAoS(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(build_aos().size());
+    }
+}
+
+static void BM_PushBackSoA(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(build_soa().size());
+    }
+}
+
+BENCHMARK(BM_SumOneFieldAoS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SumOneFieldSoA)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UpdateAoS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UpdateSoA)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UpdateSoARows)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PushBackAoS)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PushBackSoA)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#include "vector_the_serene.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Network receive loop: grow a buffer, then overwrite it (memcpy stands in
+// for read())
+
+static const std::vector<uint8_t> &incoming(size_t bytes) {
+    static std::vector<uint8_t> data;
+    if (data.size() < bytes) {
+        data.assign(bytes, 0x5a);
+    }
+    return data;
+}
+
+static void BM_RefillResize(benchmark::State &state) {
+    size_t bytes = size_t(state.range(0));
+    const auto &source = incoming(bytes);
+    for (auto _ : state) {
+        VectorTheSerene<uint8_t> buffer;
+        buffer.resize(bytes);
+        std::memcpy(buffer.begin(), source.data(), bytes);
+        benchmark::DoNotOptimize(buffer.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+static void BM_RefillResizeUninitialized(benchmark::State &state) {
+    size_t bytes = size_t(state.range(0));
+    const auto &source = incoming(bytes);
+    for (auto _ : state) {
+        VectorTheSerene<uint8_t> buffer;
+        buffer.resize_uninitialized(bytes);
+        std::memcpy(buffer.begin(), source.data(), bytes);
+        benchmark::DoNotOptimize(buffer.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+static void BM_RefillResizeAndOverwrite(benchmark::State &state) {
+    size_t bytes = size_t(state.range(0));
+    const auto &source = incoming(bytes);
+    for (auto _ : state) {
+        VectorTheSerene<uint8_t> buffer;
+        buffer.resize_and_overwrite(bytes, [&](uint8_t *data, size_t n) {
+            std::memcpy(data, source.data(), n);
+            return n;
+        });
+        benchmark::DoNotOptimize(buffer.begin());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(BM_RefillResize)->Arg(64 << 10)->Arg(64 << 20);
+BENCHMARK(BM_RefillResizeUninitialized)->Arg(64 << 10)->Arg(64 << 20);
+BENCHMARK(BM_RefillResizeAndOverwrite)->Arg(64 << 10)->Arg(64 << 20);
@@ -0,0 +1,98 @@
+#include "allocator_the_vast.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Grows a vector of uint64_t to range(0) MiB with push_back, reporting the
+// peak RSS and the slowest single push_back (the growth spike). Every run
+// happens in a forked child, so that ru_maxrss belongs to that run alone.
+
+struct GrowthResult {
+    double total_ms;
+    double worst_push_us;
+    double peak_rss_mib;
+};
+
+template <typename Vector> static GrowthResult grow(size_t bytes) {
+    using clock = std::chrono::steady_clock;
+    size_t count = bytes / sizeof(uint64_t);
+    GrowthResult result{};
+    auto start = clock::now();
+    {
+        Vector v;
+        for (size_t i = 0; i < count; ++i) {
+            auto before = clock::now();
+            v.push_back(i);
+            if (i == v.capacity() / 2 || v.size() == v.capacity()) {
+                // Only time around growth points, the clock itself is not
+                // free
+                std::chrono::duration<double, std::micro> push =
+                    clock::now() - before;
+                result.worst_push_us = std::max(result.worst_push_us,
+                                                push.count());
+            }
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    std::chrono::duration<double, std::milli> total = clock::now() - start;
+    result.total_ms = total.count();
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    result.peak_rss_mib = double(usage.ru_maxrss) / 1024;
+    return result;
+}
+
+template <typename Vector> static void BM_GrowTo(benchmark::State &state) {
+    size_t bytes = size_t(state.range(0)) << 20;
+    GrowthResult result{};
+    for (auto _ : state) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            state.SkipWithError("pipe failed");
+            return;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            GrowthResult child = grow<Vector>(bytes);
+            ssize_t written = write(fds[1], &child, sizeof(child));
+            _exit(written == sizeof(child) ? 0 : 1);
+        }
+        close(fds[1]);
+        ssize_t got = read(fds[0], &result, sizeof(result));
+        close(fds[0]);
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (got != sizeof(result) || status != 0) {
+            state.SkipWithError("child failed");
+            return;
+        }
+        state.SetIterationTime(result.total_ms / 1000);
+    }
+    state.counters["peak_rss_mib"] = result.peak_rss_mib;
+    state.counters["worst_push_us"] = result.worst_push_us;
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(BM_GrowTo<VectorTheSerene<uint64_t>>)
+    ->Arg(256)
+    ->Arg(1024)
+    ->UseManualTime()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GrowTo<VastVectorTheSerene<uint64_t>>)
+    ->Arg(256)
+    ->Arg(1024)
+    ->UseManualTime()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GrowTo<std::vector<uint64_t>>)
+    ->Arg(256)
+    ->Arg(1024)
+    ->UseManualTime()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
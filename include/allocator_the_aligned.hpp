@@ -0,0 +1,107 @@
+#ifndef INCLUDE_ALLOCATOR_THE_ALIGNED_HPP_
+#define INCLUDE_ALLOCATOR_THE_ALIGNED_HPP_
+
+#include "./growth_policies.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Allocator whose buffers start at a multiple of Alignment bytes (a cache
+// line by default), so that SIMD kernels can use aligned loads without a
+// peeling loop. VectorTheSerene picks the alignment up through
+// serene_buffer_alignment, and data() returns std::assume_aligned pointers.
+//
+// Buffers of at least huge_page_threshold bytes are aligned to 2 MiB and,
+// on Linux, marked with MADV_HUGEPAGE, so that large random-access buffers
+// need fewer TLB entries. Off by default.
+template <typename T, size_t Alignment = 64> class AllocatorTheAligned {
+  private:
+    static_assert(std::has_single_bit(Alignment),
+                  "Alignment must be a power of two");
+
+    size_t huge_page_threshold_;
+
+    template <typename, size_t> friend class AllocatorTheAligned;
+
+    bool is_huge(size_t n) const {
+        return n * sizeof(T) >= huge_page_threshold_;
+    }
+
+    static size_t huge_bytes(size_t n) {
+        return (n * sizeof(T) + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // The alignment can't be less than T needs anyway
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+    static constexpr size_t huge_page_size = size_t(2) << 20;
+    static constexpr size_t no_huge_pages = std::numeric_limits<size_t>::max();
+
+    // The non-type parameter stops allocator_traits from rebinding on its own
+    template <typename U> struct rebind {
+        using other = AllocatorTheAligned<U, Alignment>;
+    };
+
+    explicit AllocatorTheAligned(
+        size_t huge_page_threshold = no_huge_pages) noexcept
+        : huge_page_threshold_(huge_page_threshold) {}
+    template <typename U>
+    AllocatorTheAligned(const AllocatorTheAligned<U, Alignment> &other) noexcept
+        : huge_page_threshold_(other.huge_page_threshold_) {}
+
+    size_t huge_page_threshold() const { return huge_page_threshold_; }
+
+    T *allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (is_huge(n)) {
+            void *p = ::operator new(huge_bytes(n),
+                                     std::align_val_t(huge_page_size));
+#ifdef __linux__
+            // Only advice: transparent huge pages may be disabled
+            madvise(p, huge_bytes(n), MADV_HUGEPAGE);
+#endif
+            return static_cast<T *>(p);
+        }
+        return static_cast<T *>(
+            ::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        if (is_huge(n)) {
+            ::operator delete(p, huge_bytes(n),
+                              std::align_val_t(huge_page_size));
+            return;
+        }
+        ::operator delete(p, n * sizeof(T), std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AllocatorTheAligned<U, Alignment> &other) const
+        noexcept {
+        return huge_page_threshold_ == other.huge_page_threshold_;
+    }
+};
+
+// Aligned buffers whose capacity is also padded to whole Alignment-byte
+// lanes, e.g. AlignedVectorTheSerene<float> for AVX-512 kernels
+template <typename T, size_t Alignment = 64>
+using AlignedVectorTheSerene =
+    VectorTheSerene<T, AllocatorTheAligned<T, Alignment>,
+                    LanePaddedGrowth<Alignment>>;
+
+#endif // INCLUDE_ALLOCATOR_THE_ALIGNED_HPP_
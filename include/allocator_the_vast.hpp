@@ -0,0 +1,147 @@
+#ifndef INCLUDE_ALLOCATOR_THE_VAST_HPP_
+#define INCLUDE_ALLOCATOR_THE_VAST_HPP_
+
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ALLOCATOR_THE_VAST_MMAP 1
+#endif
+
+// Allocator for very large buffers of trivially copyable types. Buffers of at
+// least threshold bytes are page-aligned mmap regions that grow with mremap,
+// so growing a 1 GB VectorTheSerene is a page table update instead of a copy
+// and never needs the old and the new buffer at the same time. Smaller
+// buffers come from malloc and grow with realloc.
+//
+// VectorTheSerene picks up reallocate() automatically for trivially copyable
+// elements.
+template <typename T> class AllocatorTheVast {
+  private:
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned types are not supported");
+
+    size_t threshold_;
+
+    template <typename U> friend class AllocatorTheVast;
+
+    bool is_mapped(size_t n) const { return n * sizeof(T) >= threshold_; }
+
+#ifdef ALLOCATOR_THE_VAST_MMAP
+    static size_t page_size() {
+        static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static size_t mapped_bytes(size_t n) {
+        return (n * sizeof(T) + page_size() - 1) & ~(page_size() - 1);
+    }
+
+    static T *map(size_t n) {
+        void *p = mmap(nullptr, mapped_bytes(n), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+
+    static T *remap(T *p, size_t old_n, size_t new_n) {
+#ifdef __linux__
+        void *result = mremap(p, mapped_bytes(old_n), mapped_bytes(new_n),
+                              MREMAP_MAYMOVE);
+        if (result == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(result);
+#else
+        if (mapped_bytes(old_n) == mapped_bytes(new_n)) {
+            return p;
+        }
+        T *result = map(new_n);
+        std::memcpy(result, p, std::min(old_n, new_n) * sizeof(T));
+        munmap(p, mapped_bytes(old_n));
+        return result;
+#endif
+    }
+#endif
+
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static constexpr size_t default_threshold = 1 << 20;
+
+    explicit AllocatorTheVast(size_t threshold = default_threshold) noexcept
+        : threshold_(threshold) {}
+    template <typename U>
+    AllocatorTheVast(const AllocatorTheVast<U> &other) noexcept
+        : threshold_(other.threshold_) {}
+
+    size_t threshold() const { return threshold_; }
+
+    T *allocate(size_t n) {
+#ifdef ALLOCATOR_THE_VAST_MMAP
+        if (is_mapped(n)) {
+            return map(n);
+        }
+#endif
+        if (void *p = std::malloc(n * sizeof(T))) {
+            return static_cast<T *>(p);
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+#ifdef ALLOCATOR_THE_VAST_MMAP
+        if (is_mapped(n)) {
+            munmap(p, mapped_bytes(n));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+    // Resizes the buffer keeping min(old_n, new_n) elements, possibly moving
+    // it. Only valid for trivially copyable T. On failure throws
+    // std::bad_alloc and leaves p untouched.
+    T *reallocate(T *p, size_t old_n, size_t new_n) {
+#ifdef ALLOCATOR_THE_VAST_MMAP
+        bool old_mapped = is_mapped(old_n);
+        bool new_mapped = is_mapped(new_n);
+        if (old_mapped && new_mapped) {
+            return remap(p, old_n, new_n);
+        }
+        if (old_mapped || new_mapped) {
+            // Crossing the threshold: one copy, then never again
+            T *result = allocate(new_n);
+            std::memcpy(static_cast<void *>(result), p,
+                        std::min(old_n, new_n) * sizeof(T));
+            deallocate(p, old_n);
+            return result;
+        }
+#endif
+        if (void *result = std::realloc(p, new_n * sizeof(T))) {
+            return static_cast<T *>(result);
+        }
+        throw std::bad_alloc();
+    }
+
+    template <typename U>
+    bool operator==(const AllocatorTheVast<U> &other) const noexcept {
+        return threshold_ == other.threshold_;
+    }
+};
+
+template <typename T>
+using VastVectorTheSerene = VectorTheSerene<T, AllocatorTheVast<T>>;
+
+#endif // INCLUDE_ALLOCATOR_THE_VAST_HPP_
@@ -0,0 +1,240 @@
+#ifndef INCLUDE_ARENA_THE_FRUGAL_HPP_
+#define INCLUDE_ARENA_THE_FRUGAL_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Bump-pointer arena: allocation is a pointer increment, deallocation is a
+// no-op and everything is given back at once with reset(). Meant for
+// per-request containers, e.g. pmr::VectorTheSerene<T> on thread_arena().
+// Not thread-safe - use one arena per thread.
+class ArenaTheFrugal : public std::pmr::memory_resource {
+  private:
+    struct Chunk {
+        Chunk *next;
+        size_t size; // Including this header
+    };
+
+    std::pmr::memory_resource *upstream_;
+    size_t next_chunk_size_;
+    Chunk *chunks_ = nullptr;
+    std::byte *cursor_ = nullptr;
+    std::byte *limit_ = nullptr;
+    size_t bytes_allocated_ = 0;
+
+    void add_chunk(size_t min_bytes) {
+        size_t chunk_size =
+            std::max(next_chunk_size_, min_bytes + sizeof(Chunk));
+        auto chunk = static_cast<Chunk *>(
+            upstream_->allocate(chunk_size, alignof(std::max_align_t)));
+        chunk->next = chunks_;
+        chunk->size = chunk_size;
+        chunks_ = chunk;
+        cursor_ = reinterpret_cast<std::byte *>(chunk + 1);
+        limit_ = reinterpret_cast<std::byte *>(chunk) + chunk_size;
+        // Grow geometrically so that big requests need few chunks
+        next_chunk_size_ = chunk_size * 2;
+    }
+
+    void free_chunks(Chunk *chunk) {
+        while (chunk != nullptr) {
+            auto next = chunk->next;
+            upstream_->deallocate(chunk, chunk->size,
+                                  alignof(std::max_align_t));
+            chunk = next;
+        }
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        auto aligned = reinterpret_cast<std::byte *>(
+            (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) &
+            ~(uintptr_t(alignment) - 1));
+        if (cursor_ == nullptr || aligned + bytes > limit_) {
+            add_chunk(bytes + alignment);
+            aligned = reinterpret_cast<std::byte *>(
+                (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) &
+                ~(uintptr_t(alignment) - 1));
+        }
+        cursor_ = aligned + bytes;
+        bytes_allocated_ += bytes;
+        return aligned;
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {
+        // Memory is only given back by reset()
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept
+        override {
+        return this == &other;
+    }
+
+  public:
+    explicit ArenaTheFrugal(
+        size_t initial_chunk_size = 64 * 1024,
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream),
+          next_chunk_size_(std::max(initial_chunk_size, 2 * sizeof(Chunk))) {}
+
+    ArenaTheFrugal(const ArenaTheFrugal &) = delete;
+    ArenaTheFrugal &operator=(const ArenaTheFrugal &) = delete;
+
+    ~ArenaTheFrugal() override { free_chunks(chunks_); }
+
+    // Frees everything allocated so far in one shot. The newest (and largest)
+    // chunk is kept, so a steady request loop stops touching upstream after
+    // warming up.
+    void reset() {
+        if (chunks_ == nullptr) {
+            return;
+        }
+        free_chunks(chunks_->next);
+        chunks_->next = nullptr;
+        cursor_ = reinterpret_cast<std::byte *>(chunks_ + 1);
+        limit_ = reinterpret_cast<std::byte *>(chunks_) + chunks_->size;
+        bytes_allocated_ = 0;
+    }
+
+    // Same as reset(), but returns every chunk to upstream
+    void release() {
+        free_chunks(chunks_);
+        chunks_ = nullptr;
+        cursor_ = nullptr;
+        limit_ = nullptr;
+        bytes_allocated_ = 0;
+    }
+
+    size_t bytes_allocated() const { return bytes_allocated_; }
+};
+
+// Per-thread arena for request-scoped containers
+inline ArenaTheFrugal &thread_arena() {
+    thread_local ArenaTheFrugal arena;
+    return arena;
+}
+
+// Size-class pool: requests up to max_pooled_size are rounded up to a power
+// of two and served from per-class free lists carved out of upstream blocks,
+// bigger ones go to upstream directly. Unlike ArenaTheFrugal it reuses freed
+// blocks, so it suits long-lived containers that grow and shrink.
+// Not thread-safe.
+class PoolTheTidy : public std::pmr::memory_resource {
+  private:
+    static constexpr size_t min_class_size = 16;
+    static constexpr size_t max_pooled_size = 4096;
+    static constexpr size_t class_count =
+        std::countr_zero(max_pooled_size) - std::countr_zero(min_class_size) +
+        1;
+    static constexpr size_t block_size = 64 * 1024;
+
+    struct FreeNode {
+        FreeNode *next;
+    };
+    struct Block {
+        Block *next;
+    };
+
+    std::pmr::memory_resource *upstream_;
+    FreeNode *free_lists_[class_count] = {};
+    Block *blocks_ = nullptr;
+    std::byte *cursor_ = nullptr;
+    std::byte *limit_ = nullptr;
+
+    static size_t class_of(size_t bytes) {
+        size_t rounded = std::bit_ceil(std::max(bytes, min_class_size));
+        return std::countr_zero(rounded) - std::countr_zero(min_class_size);
+    }
+
+    static size_t class_size(size_t size_class) {
+        return min_class_size << size_class;
+    }
+
+    // Every class size is a power of two and blocks are aligned to
+    // max_pooled_size, so aligning the cursor to the class size aligns the
+    // carved piece to itself. The bytes skipped on the way are pieces of
+    // smaller classes, aligned to their own size, so they go to the free
+    // lists instead of being wasted.
+    std::byte *carve(size_t bytes) {
+        while (cursor_ != nullptr &&
+               (reinterpret_cast<uintptr_t>(cursor_) & (bytes - 1)) != 0) {
+            size_t piece = size_t(1)
+                           << std::countr_zero(
+                                  reinterpret_cast<uintptr_t>(cursor_));
+            auto node = reinterpret_cast<FreeNode *>(cursor_);
+            node->next = free_lists_[class_of(piece)];
+            free_lists_[class_of(piece)] = node;
+            cursor_ += piece;
+        }
+        if (cursor_ == nullptr || cursor_ + bytes > limit_) {
+            auto block = static_cast<Block *>(
+                upstream_->allocate(block_size, max_pooled_size));
+            block->next = blocks_;
+            blocks_ = block;
+            // The header takes the first max_pooled_size bytes to keep the
+            // rest aligned
+            cursor_ = reinterpret_cast<std::byte *>(block) + max_pooled_size;
+            limit_ = reinterpret_cast<std::byte *>(block) + block_size;
+        }
+        auto result = cursor_;
+        cursor_ += bytes;
+        return result;
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > max_pooled_size || alignment > max_pooled_size) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        size_t size_class = class_of(std::max(bytes, alignment));
+        if (auto node = free_lists_[size_class]) {
+            free_lists_[size_class] = node->next;
+            return node;
+        }
+        return carve(class_size(size_class));
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        if (bytes > max_pooled_size || alignment > max_pooled_size) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        size_t size_class = class_of(std::max(bytes, alignment));
+        auto node = static_cast<FreeNode *>(p);
+        node->next = free_lists_[size_class];
+        free_lists_[size_class] = node;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept
+        override {
+        return this == &other;
+    }
+
+  public:
+    explicit PoolTheTidy(
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    PoolTheTidy(const PoolTheTidy &) = delete;
+    PoolTheTidy &operator=(const PoolTheTidy &) = delete;
+
+    ~PoolTheTidy() override { release(); }
+
+    // Returns all pooled blocks to upstream. Oversized allocations are not
+    // tracked and must have been deallocated already.
+    void release() {
+        while (blocks_ != nullptr) {
+            auto next = blocks_->next;
+            upstream_->deallocate(blocks_, block_size, max_pooled_size);
+            blocks_ = next;
+        }
+        std::fill(std::begin(free_lists_), std::end(free_lists_), nullptr);
+        cursor_ = nullptr;
+        limit_ = nullptr;
+    }
+};
+
+#endif // INCLUDE_ARENA_THE_FRUGAL_HPP_
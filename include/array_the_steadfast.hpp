@@ -1,6 +1,8 @@
 #ifndef INCLUDE_ARRAY_THE_STEADFAST_HPP_
 #define INCLUDE_ARRAY_THE_STEADFAST_HPP_
 
+#include "./serene_checks.hpp"
+#include "./serene_compare.hpp"
 #include <compare>
 #include <cstddef>
 #include <iostream>
@@ -19,15 +21,15 @@ template <typename T, size_t N> class ArrayTheSteadfast {
     using reverse_iterator = std::reverse_iterator<T *>;
     using const_reverse_iterator = std::reverse_iterator<const T *>;
 
-    ArrayTheSteadfast() = default;
+    constexpr ArrayTheSteadfast() = default;
 
-    ArrayTheSteadfast(const T &value) {
+    constexpr ArrayTheSteadfast(const T &value) {
         for (size_t i = 0; i < N; ++i) {
             data_[i] = value;
         }
     }
 
-    ArrayTheSteadfast(std::initializer_list<T> list) {
+    constexpr ArrayTheSteadfast(std::initializer_list<T> list) {
         auto it = list.begin();
         size_t i = 0;
 
@@ -40,68 +42,90 @@ template <typename T, size_t N> class ArrayTheSteadfast {
         }
     }
 
-    T &operator[](size_t index) { return data_[index]; }
-    const T &operator[](size_t index) const { return data_[index]; }
+    // Only checked at the hardened and assert levels, see serene_checks.hpp
+    constexpr T &operator[](size_t index) {
+        serene_check_index(index < N);
+        return data_[index];
+    }
+    constexpr const T &operator[](size_t index) const {
+        serene_check_index(index < N);
+        return data_[index];
+    }
 
-    T &at(size_t index) {
+    constexpr T &at(size_t index) {
         if (index >= N) {
             throw std::out_of_range("index out of range");
         }
         return data_[index];
     }
 
-    const T &at(size_t index) const {
+    constexpr const T &at(size_t index) const {
         if (index >= N) {
             throw std::out_of_range("index out of range");
         }
         return data_[index];
     }
 
-    T &front() { return data_[0]; }
-    const T &front() const { return data_[0]; }
+    constexpr T &front() {
+        serene_check(N != 0, "array is empty");
+        return data_[0];
+    }
+    constexpr const T &front() const {
+        serene_check(N != 0, "array is empty");
+        return data_[0];
+    }
 
-    T &back() { return data_[N - 1]; }
-    const T &back() const { return data_[N - 1]; }
+    constexpr T &back() {
+        serene_check(N != 0, "array is empty");
+        return data_[N - 1];
+    }
+    constexpr const T &back() const {
+        serene_check(N != 0, "array is empty");
+        return data_[N - 1];
+    }
 
-    T *data() { return data_; }
-    const T *data() const { return data_; }
+    constexpr T *data() { return data_; }
+    constexpr const T *data() const { return data_; }
 
-    iterator begin() { return data_; }
-    iterator end() { return data_ + N; }
+    constexpr iterator begin() { return data_; }
+    constexpr iterator end() { return data_ + N; }
 
-    const_iterator begin() const { return data_; }
-    const_iterator end() const { return data_ + N; }
+    constexpr const_iterator begin() const { return data_; }
+    constexpr const_iterator end() const { return data_ + N; }
 
-    const_iterator cbegin() const { return data_; }
-    const_iterator cend() const { return data_ + N; }
+    constexpr const_iterator cbegin() const { return data_; }
+    constexpr const_iterator cend() const { return data_ + N; }
 
-    reverse_iterator rbegin() { return reverse_iterator(end()); }
-    reverse_iterator rend() { return reverse_iterator(begin()); }
+    constexpr reverse_iterator rbegin() { return reverse_iterator(end()); }
+    constexpr reverse_iterator rend() { return reverse_iterator(begin()); }
 
-    const_reverse_iterator rbegin() const {
+    constexpr const_reverse_iterator rbegin() const {
         return const_reverse_iterator(end());
     }
-    const_reverse_iterator rend() const {
+    constexpr const_reverse_iterator rend() const {
         return const_reverse_iterator(begin());
     }
 
-    const_reverse_iterator crbegin() const {
+    constexpr const_reverse_iterator crbegin() const {
         return const_reverse_iterator(cend());
     }
-    const_reverse_iterator crend() const {
+    constexpr const_reverse_iterator crend() const {
         return const_reverse_iterator(cbegin());
     }
 
     constexpr size_t size() const { return N; }
     constexpr bool is_empty() const { return N == 0; }
 
-    void swap(ArrayTheSteadfast &other) {
+    constexpr void swap(ArrayTheSteadfast &other) {
         for (size_t i = 0; i < N; ++i) {
             std::swap(data_[i], other.data_[i]);
         }
     }
 
-    bool operator==(const ArrayTheSteadfast &other) const {
+    constexpr bool operator==(const ArrayTheSteadfast &other) const {
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_equal(data_, other.data_, N);
+        }
         for (size_t i = 0; i < N; ++i) {
             if (!(data_[i] == other.data_[i])) {
                 return false;
@@ -110,11 +134,14 @@ template <typename T, size_t N> class ArrayTheSteadfast {
         return true;
     }
 
-    bool operator!=(const ArrayTheSteadfast &other) const {
+    constexpr bool operator!=(const ArrayTheSteadfast &other) const {
         return !(*this == other);
     }
 
-    auto operator<=>(const ArrayTheSteadfast &other) const {
+    constexpr auto operator<=>(const ArrayTheSteadfast &other) const {
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_compare(data_, N, other.data_, N);
+        }
         for (size_t i = 0; i < N; ++i) {
             if (data_[i] < other.data_[i]) {
                 return std::strong_ordering::less;
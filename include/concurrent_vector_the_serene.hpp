@@ -0,0 +1,244 @@
+#ifndef INCLUDE_CONCURRENT_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_CONCURRENT_VECTOR_THE_SERENE_HPP_
+
+#include "./vector_the_serene.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// A vector that many threads can append to at once without a lock. The
+// elements live in buckets of 32, 64, 128, ... elements that are allocated
+// on demand and never move, so push_back never copies existing elements and
+// references to them stay valid for the lifetime of the vector.
+//
+// push_back takes a slot with one fetch_add and is wait-free apart from the
+// allocation of a new bucket; when two threads race to allocate the same
+// bucket, the loser frees its copy. Every slot has a ready flag that is set
+// once its element is constructed, so readers never see half-built
+// elements.
+//
+// Only the appends and the reads are thread-safe; clear() and destruction
+// must not overlap with anything else.
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVectorTheSerene {
+  private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using flag_allocator =
+        typename alloc_traits::template rebind_alloc<std::atomic<bool>>;
+    using flag_traits = std::allocator_traits<flag_allocator>;
+
+    static constexpr size_t first_bucket_bits = 5;
+    static constexpr size_t first_bucket_size = size_t(1)
+                                                << first_bucket_bits;
+    // Enough for any index that fits into size_t
+    static constexpr size_t bucket_count =
+        std::numeric_limits<size_t>::digits - first_bucket_bits;
+
+    struct Position {
+        size_t bucket;
+        size_t offset;
+    };
+
+    // Bucket b holds first_bucket_size << b elements, so the index shifted
+    // by first_bucket_size has its highest bit at b + first_bucket_bits
+    static Position locate(size_t index) {
+        size_t shifted = index + first_bucket_size;
+        size_t high_bit = std::bit_width(shifted) - 1;
+        return {high_bit - first_bucket_bits,
+                shifted - (size_t(1) << high_bit)};
+    }
+
+    static size_t bucket_size(size_t bucket) {
+        return first_bucket_size << bucket;
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    std::atomic<size_t> size_{0};
+    std::array<std::atomic<T *>, bucket_count> buckets_{};
+    std::array<std::atomic<std::atomic<bool> *>, bucket_count> ready_{};
+
+    std::atomic<bool> *allocate_flags(size_t bucket) {
+        flag_allocator alloc(alloc_);
+        size_t n = bucket_size(bucket);
+        std::atomic<bool> *flags = flag_traits::allocate(alloc, n);
+        for (size_t i = 0; i < n; ++i) {
+            flag_traits::construct(alloc, flags + i, false);
+        }
+        return flags;
+    }
+
+    void free_flags(std::atomic<bool> *flags, size_t bucket) {
+        flag_allocator alloc(alloc_);
+        flag_traits::deallocate(alloc, flags, bucket_size(bucket));
+    }
+
+    // Publishes a freshly allocated bucket, or adopts the one another
+    // thread published first
+    template <typename P, typename Allocate, typename Free>
+    static P *ensure(std::atomic<P *> &slot, Allocate allocate, Free free) {
+        P *current = slot.load(std::memory_order_acquire);
+        if (current != nullptr) {
+            return current;
+        }
+        P *fresh = allocate();
+        if (slot.compare_exchange_strong(current, fresh,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+            return fresh;
+        }
+        free(fresh);
+        return current;
+    }
+
+    T *ensure_bucket(size_t bucket) {
+        ensure(
+            ready_[bucket], [&] { return allocate_flags(bucket); },
+            [&](std::atomic<bool> *flags) { free_flags(flags, bucket); });
+        return ensure(
+            buckets_[bucket],
+            [&] { return alloc_traits::allocate(alloc_, bucket_size(bucket)); },
+            [&](T *elements) {
+                alloc_traits::deallocate(alloc_, elements,
+                                         bucket_size(bucket));
+            });
+    }
+
+    T *slot(size_t index) const {
+        Position position = locate(index);
+        return buckets_[position.bucket].load(std::memory_order_acquire) +
+               position.offset;
+    }
+
+    void release_buckets() {
+        size_t n = size_.load(std::memory_order_relaxed);
+        for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            T *elements = buckets_[bucket].load(std::memory_order_relaxed);
+            std::atomic<bool> *flags =
+                ready_[bucket].load(std::memory_order_relaxed);
+            size_t first = bucket_size(bucket) - first_bucket_size;
+            for (size_t i = 0; elements != nullptr &&
+                               i < bucket_size(bucket) && first + i < n;
+                 ++i) {
+                if (flags[i].load(std::memory_order_relaxed)) {
+                    alloc_traits::destroy(alloc_, elements + i);
+                }
+            }
+            if (elements != nullptr) {
+                alloc_traits::deallocate(alloc_, elements,
+                                         bucket_size(bucket));
+            }
+            if (flags != nullptr) {
+                free_flags(flags, bucket);
+            }
+            buckets_[bucket].store(nullptr, std::memory_order_relaxed);
+            ready_[bucket].store(nullptr, std::memory_order_relaxed);
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename... Args> size_t append(Args &&...args) {
+        size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        Position position = locate(index);
+        T *where = ensure_bucket(position.bucket) + position.offset;
+        alloc_traits::construct(alloc_, where, std::forward<Args>(args)...);
+        ready_[position.bucket]
+            .load(std::memory_order_relaxed)[position.offset]
+            .store(true, std::memory_order_release);
+        return index;
+    }
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    ConcurrentVectorTheSerene() : ConcurrentVectorTheSerene(Allocator()) {}
+    explicit ConcurrentVectorTheSerene(const Allocator &alloc)
+        : alloc_(alloc) {}
+
+    ConcurrentVectorTheSerene(const ConcurrentVectorTheSerene &) = delete;
+    ConcurrentVectorTheSerene &
+    operator=(const ConcurrentVectorTheSerene &) = delete;
+
+    ~ConcurrentVectorTheSerene() { release_buckets(); }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    // Appends an element and returns its index, which is what is_ready()
+    // and at() take. The element stays where it is until clear() or
+    // destruction. If the constructor throws, the slot stays taken but
+    // never becomes ready.
+    template <typename... Args> size_t emplace_back(Args &&...args) {
+        return append(std::forward<Args>(args)...);
+    }
+
+    size_t push_back(const T &value) { return append(value); }
+    size_t push_back(T &&value) { return append(std::move(value)); }
+
+    // Allocates the buckets for the first n elements up front
+    void reserve(size_t n) {
+        if (n == 0) {
+            return;
+        }
+        for (size_t bucket = 0; bucket <= locate(n - 1).bucket; ++bucket) {
+            ensure_bucket(bucket);
+        }
+    }
+
+    // Number of slots taken so far, including elements that are still
+    // being constructed by other threads
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    bool is_empty() const { return size() == 0; }
+    bool empty() const { return size() == 0; }
+
+    // Whether the element at index has been constructed and can be read
+    bool is_ready(size_t index) const {
+        if (index >= size()) {
+            return false;
+        }
+        Position position = locate(index);
+        std::atomic<bool> *flags =
+            ready_[position.bucket].load(std::memory_order_acquire);
+        return flags != nullptr &&
+               flags[position.offset].load(std::memory_order_acquire);
+    }
+
+    // Unchecked: the element has to be ready, e.g. its index came from
+    // push_back in this thread, or is_ready(index) returned true
+    T &operator[](size_t index) { return *slot(index); }
+    const T &operator[](size_t index) const { return *slot(index); }
+
+    T &at(size_t index) {
+        if (!is_ready(index)) {
+            throw std::out_of_range("index out of range or not ready");
+        }
+        return *slot(index);
+    }
+    const T &at(size_t index) const {
+        if (!is_ready(index)) {
+            throw std::out_of_range("index out of range or not ready");
+        }
+        return *slot(index);
+    }
+
+    // Copies the longest prefix of ready elements into a contiguous vector.
+    // Safe while other threads keep appending.
+    VectorTheSerene<T> snapshot() const {
+        VectorTheSerene<T> result;
+        size_t n = size();
+        result.reserve(n);
+        for (size_t i = 0; i < n && is_ready(i); ++i) {
+            result.push_back(*slot(i));
+        }
+        return result;
+    }
+
+    // Not thread-safe
+    void clear() { release_buckets(); }
+};
+
+#endif // INCLUDE_CONCURRENT_VECTOR_THE_SERENE_HPP_
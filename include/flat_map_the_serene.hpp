@@ -0,0 +1,381 @@
+#ifndef INCLUDE_FLAT_MAP_THE_SERENE_HPP_
+#define INCLUDE_FLAT_MAP_THE_SERENE_HPP_
+
+#include "./flat_set_the_serene.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// An ordered map stored as two VectorTheSerenes: the sorted keys, and the
+// values in the same order. Lookups only touch the keys, so a search
+// through a table with big values still reads densely packed keys, and
+// scanning just the values is a plain loop over values().
+//
+// Like FlatSetTheSerene, single inserts and erases shift the entries after
+// them; the range constructor and insert(range) sort and merge once.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          FlatLayout Layout = FlatLayout::sorted>
+class FlatMapTheSerene {
+  private:
+    serene_flat_detail::SortedKeys<Key, Compare, Layout> keys_;
+    VectorTheSerene<T> values_;
+
+    VectorTheSerene<Key> &key_data() { return keys_.keys(); }
+    const VectorTheSerene<Key> &key_data() const { return keys_.keys(); }
+
+    template <typename... Args>
+    size_t insert_at(size_t index, Key key, Args &&...args) {
+        key_data().insert(key_data().begin() + index, std::move(key));
+        try {
+            values_.insert(values_.begin() + index,
+                           T(std::forward<Args>(args)...));
+        } catch (...) {
+            key_data().erase(key_data().begin() + index);
+            throw;
+        }
+        keys_.changed();
+        return index;
+    }
+
+    // Position of key, and whether it is already there
+    std::pair<size_t, bool> search(const Key &key) const {
+        size_t index = keys_.lower_bound(key);
+        return {index,
+                index < size() && keys_.equivalent(key_data()[index], key)};
+    }
+
+  public:
+    // Points at the key and the value at the same position. Dereferencing
+    // gives a pair of references, so `auto [key, value] = *it` and
+    // `it->second = x` both work.
+    template <bool Const> class Iterator {
+      private:
+        using owner = std::conditional_t<Const, const FlatMapTheSerene,
+                                         FlatMapTheSerene>;
+
+        owner *map_ = nullptr;
+        size_t index_ = 0;
+
+      public:
+        // The reference is a proxy, which the legacy categories don't
+        // allow past input iterators; ranges see the random access
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            std::pair<const Key &, std::conditional_t<Const, const T &, T &>>;
+
+        struct pointer {
+            reference pair;
+            reference *operator->() { return &pair; }
+        };
+
+        Iterator() = default;
+        Iterator(owner *map, size_t index) : map_(map), index_(index) {}
+        // iterator to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other)
+            : map_(other.map_), index_(other.index_) {}
+
+        reference operator*() const {
+            return {map_->key_data()[index_], map_->values_[index_]};
+        }
+        pointer operator->() const { return {**this}; }
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        // Position in keys() and values()
+        size_t index() const { return index_; }
+
+        Iterator &operator++() {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator &operator--() {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+        Iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a,
+                                         const Iterator &b) {
+            return difference_type(a.index_) - difference_type(b.index_);
+        }
+
+        bool operator==(const Iterator &other) const {
+            return index_ == other.index_;
+        }
+        auto operator<=>(const Iterator &other) const {
+            return index_ <=> other.index_;
+        }
+
+        template <bool> friend class Iterator;
+    };
+
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    FlatMapTheSerene() = default;
+    explicit FlatMapTheSerene(const Compare &compare) : keys_(compare) {}
+
+    FlatMapTheSerene(std::initializer_list<value_type> list,
+                     const Compare &compare = Compare())
+        : keys_(compare) {
+        insert(list);
+    }
+
+    template <std::ranges::input_range Range>
+        requires(!std::is_same_v<std::remove_cvref_t<Range>, FlatMapTheSerene>)
+    explicit FlatMapTheSerene(Range &&range, const Compare &compare = Compare())
+        : keys_(compare) {
+        insert(std::forward<Range>(range));
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    // The keys in order, and the values in the same order
+    std::span<const Key> keys() const {
+        return {key_data().begin(), key_data().end()};
+    }
+    std::span<T> values() { return {values_.begin(), values_.end()}; }
+    std::span<const T> values() const {
+        return {values_.begin(), values_.end()};
+    }
+
+    size_t size() const { return key_data().size(); }
+    bool is_empty() const { return key_data().is_empty(); }
+    bool empty() const { return key_data().is_empty(); }
+
+    void reserve(size_t n) {
+        key_data().reserve(n);
+        values_.reserve(n);
+    }
+
+    void shrink_to_fit() {
+        keys_.shrink_to_fit();
+        values_.shrink_to_fit();
+    }
+
+    void clear() {
+        key_data().clear();
+        values_.clear();
+        keys_.changed();
+    }
+
+    iterator find(const Key &key) { return {this, keys_.find(key)}; }
+    const_iterator find(const Key &key) const {
+        return {this, keys_.find(key)};
+    }
+    bool contains(const Key &key) const { return keys_.contains(key); }
+    size_t count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound(const Key &key) {
+        return {this, keys_.lower_bound(key)};
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return {this, keys_.lower_bound(key)};
+    }
+    iterator upper_bound(const Key &key) {
+        return {this, keys_.upper_bound(key)};
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return {this, keys_.upper_bound(key)};
+    }
+
+    T &at(const Key &key) {
+        size_t index = keys_.find(key);
+        if (index == size()) {
+            throw std::out_of_range("key not found");
+        }
+        return values_[index];
+    }
+    const T &at(const Key &key) const {
+        size_t index = keys_.find(key);
+        if (index == size()) {
+            throw std::out_of_range("key not found");
+        }
+        return values_[index];
+    }
+
+    // Inserts a default-constructed value if key is missing
+    T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+    // Does nothing if key is already there
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+        auto [index, found] = search(key);
+        if (found) {
+            return {{this, index}, false};
+        }
+        insert_at(index, key, std::forward<Args>(args)...);
+        return {{this, index}, true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type &item) {
+        return try_emplace(item.first, item.second);
+    }
+
+    template <typename Value>
+    std::pair<iterator, bool> insert_or_assign(const Key &key,
+                                               Value &&value) {
+        auto [index, found] = search(key);
+        if (found) {
+            values_[index] = std::forward<Value>(value);
+            return {{this, index}, false};
+        }
+        insert_at(index, key, std::forward<Value>(value));
+        return {{this, index}, true};
+    }
+
+    // Adds all the (key, value) pairs of range at once: they are sorted by
+    // key and then merged with the existing entries in a single pass, in
+    // O(m log m + n) instead of O(m n) for m single inserts. Like insert(),
+    // it keeps existing entries, and the first of equal new keys.
+    //
+    // If the comparator or a move throws while the new entries are sorted,
+    // the map is left as it was. Past that point the old entries are being
+    // moved, and a throw leaves the map empty.
+    template <std::ranges::input_range Range> void insert(Range &&range) {
+        VectorTheSerene<value_type> items;
+        items.append_range(std::forward<Range>(range));
+        const Compare &compare = keys_.compare();
+        std::stable_sort(items.begin(), items.end(),
+                         [&](const value_type &a, const value_type &b) {
+                             return compare(a.first, b.first);
+                         });
+
+        VectorTheSerene<Key> merged_keys;
+        VectorTheSerene<T> merged_values;
+        merged_keys.reserve(size() + items.size());
+        merged_values.reserve(size() + items.size());
+        auto &old_keys = key_data();
+        try {
+            size_t i = 0;
+            size_t j = 0;
+            while (i < old_keys.size() || j < items.size()) {
+                bool take_new = i == old_keys.size() ||
+                                (j < items.size() &&
+                                 compare(items[j].first, old_keys[i]));
+                if (!take_new) {
+                    // Skip the new entries that this one shadows
+                    while (j < items.size() &&
+                           !compare(old_keys[i], items[j].first)) {
+                        ++j;
+                    }
+                    merged_keys.push_back(std::move(old_keys[i]));
+                    merged_values.push_back(std::move(values_[i]));
+                    ++i;
+                    continue;
+                }
+                if (!merged_keys.is_empty() &&
+                    keys_.equivalent(merged_keys.back(), items[j].first)) {
+                    ++j;
+                    continue;
+                }
+                merged_keys.push_back(std::move(items[j].first));
+                merged_values.push_back(std::move(items[j].second));
+                ++j;
+            }
+            old_keys = std::move(merged_keys);
+            values_ = std::move(merged_values);
+        } catch (...) {
+            key_data().clear();
+            values_.clear();
+            keys_.changed();
+            throw;
+        }
+        keys_.changed();
+    }
+
+    void insert(std::initializer_list<value_type> list) {
+        insert(std::span<const value_type>(list.begin(), list.size()));
+    }
+
+    size_t erase(const Key &key) {
+        size_t index = keys_.find(key);
+        if (index == size()) {
+            return 0;
+        }
+        erase(const_iterator(this, index));
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t index = pos.index();
+        key_data().erase(key_data().begin() + index);
+        values_.erase(values_.begin() + index);
+        keys_.changed();
+        return {this, index};
+    }
+
+    bool operator==(const FlatMapTheSerene &other) const {
+        return key_data() == other.key_data() && values_ == other.values_;
+    }
+};
+
+template <typename Key, typename T, typename Compare, FlatLayout Layout>
+void print_vector(const FlatMapTheSerene<Key, T, Compare, Layout> &map) {
+    for (const auto &[key, value] : map) {
+        std::cout << key << ":" << value << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_FLAT_MAP_THE_SERENE_HPP_
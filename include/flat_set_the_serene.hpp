@@ -0,0 +1,349 @@
+#ifndef INCLUDE_FLAT_SET_THE_SERENE_HPP_
+#define INCLUDE_FLAT_SET_THE_SERENE_HPP_
+
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// How a flat container finds keys:
+//   sorted    - branchless binary search over the sorted keys
+//   eytzinger - an extra copy of the keys in breadth-first (Eytzinger)
+//               order, where the search walks down the tree touching
+//               consecutive cache lines. Faster lookups in big tables, but
+//               every modification rebuilds the copy in O(n), so meant for
+//               read-mostly tables.
+enum class FlatLayout { sorted, eytzinger };
+
+namespace serene_flat_detail {
+
+// First index in [0, n) for which pred is false, where pred is true for a
+// prefix of the keys. The loop has no data-dependent branch: the compiler
+// turns the ternary into a conditional move.
+template <typename Key, typename Predicate>
+size_t partition_point(const Key *keys, size_t n, Predicate pred) {
+    if (n == 0) {
+        return 0;
+    }
+    const Key *base = keys;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = pred(base[half]) ? base + half : base;
+        n -= half;
+    }
+    return size_t(base - keys) + size_t(pred(*base));
+}
+
+// Drops the items from new_end on, which may be none
+template <typename T>
+void erase_to_end(VectorTheSerene<T> &vector, const T *new_end) {
+    while (vector.end() != new_end) {
+        vector.pop_back();
+    }
+}
+
+// The sorted keys, plus their Eytzinger copy if Layout asks for one
+template <typename Key, typename Compare, FlatLayout Layout>
+class SortedKeys {
+  private:
+    VectorTheSerene<Key> keys_;
+    // 1-based breadth-first order: the children of node k are 2k and 2k+1.
+    // Node k is stored at tree_[k - 1], so that Key needs no default
+    // constructor; rank_[k] is its position in keys_.
+    VectorTheSerene<Key> tree_;
+    VectorTheSerene<size_t> rank_;
+    [[no_unique_address]] Compare compare_;
+
+    const Key &node_key(size_t node) const { return tree_[node - 1]; }
+
+    size_t fill_rank(size_t node, size_t next) {
+        if (node < rank_.size()) {
+            next = fill_rank(2 * node, next);
+            rank_[node] = next++;
+            next = fill_rank(2 * node + 1, next);
+        }
+        return next;
+    }
+
+    // Nodes whose descendants a few levels down share a cache line
+    static constexpr size_t prefetch_stride =
+        std::max<size_t>(1, 64 / sizeof(Key));
+
+    // The tree node holding the partition point, or 0 if it is the end
+    template <typename Predicate>
+    size_t eytzinger_search(Predicate pred) const {
+        size_t n = keys_.size();
+        size_t node = 1;
+        while (node <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+            // The descendants are the next nodes to be read: fetch them
+            // while comparing this one. Addresses past the end are fine,
+            // a prefetch never faults.
+            __builtin_prefetch(reinterpret_cast<const void *>(
+                reinterpret_cast<std::uintptr_t>(tree_.begin()) +
+                (node * prefetch_stride - 1) * sizeof(Key)));
+#endif
+            node = 2 * node + size_t(pred(node_key(node)));
+        }
+        // Undo the right turns after the last left turn
+        return node >> (std::countr_one(node) + 1);
+    }
+
+    template <typename Predicate>
+    size_t eytzinger_partition_point(Predicate pred) const {
+        size_t node = eytzinger_search(pred);
+        return node == 0 ? keys_.size() : rank_[node];
+    }
+
+    template <typename Predicate>
+    size_t partition_point(Predicate pred) const {
+        if constexpr (Layout == FlatLayout::eytzinger) {
+            return eytzinger_partition_point(pred);
+        } else {
+            return serene_flat_detail::partition_point(keys_.begin(),
+                                                       keys_.size(), pred);
+        }
+    }
+
+  public:
+    SortedKeys() = default;
+    explicit SortedKeys(const Compare &compare) : compare_(compare) {}
+
+    const Compare &compare() const { return compare_; }
+    VectorTheSerene<Key> &keys() { return keys_; }
+    const VectorTheSerene<Key> &keys() const { return keys_; }
+
+    bool equivalent(const Key &a, const Key &b) const {
+        return !compare_(a, b) && !compare_(b, a);
+    }
+
+    size_t lower_bound(const Key &key) const {
+        return partition_point(
+            [&](const Key &item) { return compare_(item, key); });
+    }
+
+    size_t upper_bound(const Key &key) const {
+        return partition_point(
+            [&](const Key &item) { return !compare_(key, item); });
+    }
+
+    // Position of key, or size() if there is none
+    size_t find(const Key &key) const {
+        size_t index = lower_bound(key);
+        if (index < keys_.size() && !compare_(key, keys_[index])) {
+            return index;
+        }
+        return keys_.size();
+    }
+
+    // Like find(key) != size(), but the Eytzinger layout answers from
+    // the tree alone, without looking up the position
+    bool contains(const Key &key) const {
+        if constexpr (Layout == FlatLayout::eytzinger) {
+            size_t node = eytzinger_search(
+                [&](const Key &item) { return compare_(item, key); });
+            return node != 0 && !compare_(key, node_key(node));
+        } else {
+            return find(key) != keys_.size();
+        }
+    }
+
+    // Has to be called after every change to keys(). With the Eytzinger
+    // layout it rebuilds the whole tree, in O(n).
+    void changed() {
+        if constexpr (Layout == FlatLayout::eytzinger) {
+            rank_.resize(keys_.size() + 1);
+            fill_rank(1, 0);
+            tree_.clear();
+            tree_.reserve(keys_.size());
+            for (size_t node = 1; node <= keys_.size(); ++node) {
+                tree_.push_back(keys_[rank_[node]]);
+            }
+        }
+    }
+
+    void shrink_to_fit() {
+        keys_.shrink_to_fit();
+        tree_.shrink_to_fit();
+        rank_.shrink_to_fit();
+    }
+};
+
+} // namespace serene_flat_detail
+
+// An ordered set stored as a sorted VectorTheSerene: lookups are a binary
+// search over contiguous keys instead of a walk over heap nodes, and
+// iteration is a linear scan. Inserting or erasing a single key shifts the
+// keys after it, and with FlatLayout::eytzinger also rebuilds the tree, so
+// each is O(n): build big sets with the range constructor or the bulk
+// insert(range), which sort and merge once.
+template <typename Key, typename Compare = std::less<Key>,
+          FlatLayout Layout = FlatLayout::sorted>
+class FlatSetTheSerene {
+  private:
+    serene_flat_detail::SortedKeys<Key, Compare, Layout> keys_;
+
+    VectorTheSerene<Key> &data() { return keys_.keys(); }
+    const VectorTheSerene<Key> &data() const { return keys_.keys(); }
+
+  public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    // Keys can't be modified in place, that would break the order
+    using iterator = const Key *;
+    using const_iterator = const Key *;
+    using reverse_iterator = std::reverse_iterator<const Key *>;
+    using const_reverse_iterator = std::reverse_iterator<const Key *>;
+
+    FlatSetTheSerene() = default;
+    explicit FlatSetTheSerene(const Compare &compare) : keys_(compare) {}
+
+    FlatSetTheSerene(std::initializer_list<Key> list,
+                     const Compare &compare = Compare())
+        : keys_(compare) {
+        insert(list);
+    }
+
+    template <std::ranges::input_range Range>
+        requires(!std::is_same_v<std::remove_cvref_t<Range>, FlatSetTheSerene>)
+    explicit FlatSetTheSerene(Range &&range, const Compare &compare = Compare())
+        : keys_(compare) {
+        insert(std::forward<Range>(range));
+    }
+
+    iterator begin() const { return data().begin(); }
+    iterator end() const { return data().end(); }
+    iterator cbegin() const { return begin(); }
+    iterator cend() const { return end(); }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    // All the keys in order
+    std::span<const Key> keys() const { return {begin(), end()}; }
+
+    size_t size() const { return data().size(); }
+    bool is_empty() const { return data().is_empty(); }
+    bool empty() const { return data().is_empty(); }
+
+    void reserve(size_t n) { data().reserve(n); }
+    void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+    void clear() {
+        data().clear();
+        keys_.changed();
+    }
+
+    iterator find(const Key &key) const { return begin() + keys_.find(key); }
+    bool contains(const Key &key) const { return keys_.contains(key); }
+    size_t count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound(const Key &key) const {
+        return begin() + keys_.lower_bound(key);
+    }
+    iterator upper_bound(const Key &key) const {
+        return begin() + keys_.upper_bound(key);
+    }
+
+    std::pair<iterator, bool> insert(const Key &key) { return emplace(key); }
+    std::pair<iterator, bool> insert(Key &&key) {
+        return emplace(std::move(key));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        Key key(std::forward<Args>(args)...);
+        size_t index = keys_.lower_bound(key);
+        if (index < size() && keys_.equivalent(data()[index], key)) {
+            return {begin() + index, false};
+        }
+        data().insert(data().begin() + index, std::move(key));
+        keys_.changed();
+        return {begin() + index, true};
+    }
+
+    // Adds all the keys of range at once: they are appended, sorted and
+    // deduplicated, then merged with the existing keys in a single pass.
+    // O(m log m + n) instead of O(m n) for m single inserts.
+    //
+    // If the comparator or a move throws while the new keys are sorted, they
+    // are dropped and the set is left as it was. Past that point the old
+    // keys are being merged, and a throw leaves the set empty.
+    template <std::ranges::input_range Range>
+        requires(!std::is_convertible_v<Range, const Key &>)
+    void insert(Range &&range) {
+        auto &keys = data();
+        size_t old_size = keys.size();
+        const Compare &compare = keys_.compare();
+        auto equivalent = [&](const Key &a, const Key &b) {
+            return keys_.equivalent(a, b);
+        };
+        try {
+            keys.append_range(std::forward<Range>(range));
+            auto middle = keys.begin() + old_size;
+            // stable, so the first of equal new keys is the one kept
+            std::stable_sort(middle, keys.end(), compare);
+            serene_flat_detail::erase_to_end(
+                keys, std::unique(middle, keys.end(), equivalent));
+        } catch (...) {
+            serene_flat_detail::erase_to_end(keys, keys.begin() + old_size);
+            throw;
+        }
+        try {
+            auto middle = keys.begin() + old_size;
+            std::inplace_merge(keys.begin(), middle, keys.end(), compare);
+            // Existing keys come first in equal pairs, so they win
+            serene_flat_detail::erase_to_end(
+                keys, std::unique(keys.begin(), keys.end(), equivalent));
+        } catch (...) {
+            keys.clear();
+            keys_.changed();
+            throw;
+        }
+        keys_.changed();
+    }
+
+    void insert(std::initializer_list<Key> list) {
+        insert(std::span<const Key>(list.begin(), list.size()));
+    }
+
+    size_t erase(const Key &key) {
+        size_t index = keys_.find(key);
+        if (index == size()) {
+            return 0;
+        }
+        data().erase(data().begin() + index);
+        keys_.changed();
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t index = pos - begin();
+        data().erase(data().begin() + index);
+        keys_.changed();
+        return begin() + index;
+    }
+
+    bool operator==(const FlatSetTheSerene &other) const {
+        return data() == other.data();
+    }
+};
+
+template <typename Key, typename Compare, FlatLayout Layout>
+void print_vector(const FlatSetTheSerene<Key, Compare, Layout> &set) {
+    for (const auto &key : set) {
+        std::cout << key << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_FLAT_SET_THE_SERENE_HPP_
@@ -0,0 +1,90 @@
+#ifndef INCLUDE_GROWTH_POLICIES_HPP_
+#define INCLUDE_GROWTH_POLICIES_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <numeric>
+
+// Growth policies for VectorTheSerene. next_capacity() is only called when
+// required > current, and has to return at least required. All of them are
+// O(1) and start at MinCapacity elements.
+
+// The default, as in libstdc++: least allocations, up to 50% unused memory
+template <size_t MinCapacity = 16> struct DoublingGrowth {
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t /* element_size */) {
+        return std::max({MinCapacity, current * 2, required});
+    }
+};
+
+// As in MSVC and folly: freed blocks can eventually be reused by the vector
+// itself, up to 33% unused memory
+template <size_t MinCapacity = 16> struct OneAndHalfGrowth {
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t /* element_size */) {
+        return std::max({MinCapacity, current + current / 2, required});
+    }
+};
+
+// Factor of ~1.618, the largest one that still allows reusing freed blocks
+template <size_t MinCapacity = 16> struct GoldenRatioGrowth {
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t /* element_size */) {
+        return std::max({MinCapacity, current + current / 1024 * 633 +
+                                          current % 1024 * 633 / 1024,
+                         required});
+    }
+};
+
+// Grows by ~1.5x, then rounds the byte size up to the next jemalloc size
+// class (multiples of 16 up to 128 bytes, then four classes per power of
+// two), so the slack the allocator would waste anyway becomes capacity
+template <size_t MinCapacity = 16> struct SizeClassGrowth {
+    static constexpr size_t size_class(size_t bytes) {
+        if (bytes <= 128) {
+            return (bytes + 15) & ~size_t(15);
+        }
+        size_t spacing = size_t(1) << (std::bit_width(bytes - 1) - 3);
+        return (bytes + spacing - 1) & ~(spacing - 1);
+    }
+
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t element_size) {
+        size_t target =
+            std::max({MinCapacity, current + current / 2, required});
+        return size_class(target * element_size) / element_size;
+    }
+};
+
+// Linear growth: at most Increment unused elements, but push_back is no
+// longer amortized O(1). Only for vectors with a known, small bound.
+template <size_t Increment, size_t MinCapacity = Increment>
+struct FixedIncrementGrowth {
+    static_assert(Increment > 0, "Increment must be positive");
+
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t /* element_size */) {
+        return std::max({MinCapacity, current + Increment, required});
+    }
+};
+
+// Rounds the capacity chosen by Policy up so that the buffer is a whole
+// number of LaneBytes-wide SIMD registers, e.g. 64 for AVX-512: a kernel can
+// then process the slack past size() with full registers instead of a
+// scalar tail. Only applies when the vector grows, not to reserve().
+template <size_t LaneBytes, typename Policy = DoublingGrowth<>>
+struct LanePaddedGrowth {
+    static_assert(LaneBytes > 0, "LaneBytes must be positive");
+
+    static constexpr size_t next_capacity(size_t current, size_t required,
+                                          size_t element_size) {
+        size_t capacity =
+            Policy::next_capacity(current, required, element_size);
+        // Smallest element count that fills whole lanes
+        size_t step = LaneBytes / std::gcd(LaneBytes, element_size);
+        return (capacity + step - 1) / step * step;
+    }
+};
+
+#endif // INCLUDE_GROWTH_POLICIES_HPP_
@@ -0,0 +1,590 @@
+#ifndef INCLUDE_HASH_MAP_THE_SERENE_HPP_
+#define INCLUDE_HASH_MAP_THE_SERENE_HPP_
+
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace serene_hash_detail {
+
+// One control byte per slot: empty, or the low 7 bits of the hash of the
+// key stored there. There are no tombstones, see erase().
+using ctrl_t = int8_t;
+inline constexpr ctrl_t empty = -128;
+
+// Slots are probed 16 at a time: one SSE2 compare matches a 7-bit hash
+// against 16 control bytes
+inline constexpr size_t group_width = 16;
+
+struct Group {
+#ifdef __SSE2__
+    __m128i bytes;
+
+    explicit Group(const ctrl_t *ctrl)
+        : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+    // Bit i is set if byte i is h2
+    uint32_t match(ctrl_t h2) const {
+        return uint32_t(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes)));
+    }
+
+    // Only empty has the high bit set
+    uint32_t match_empty() const {
+        return uint32_t(_mm_movemask_epi8(bytes));
+    }
+#else
+    const ctrl_t *bytes;
+
+    explicit Group(const ctrl_t *ctrl) : bytes(ctrl) {}
+
+    uint32_t match(ctrl_t h2) const {
+        uint32_t result = 0;
+        for (size_t i = 0; i < group_width; ++i) {
+            result |= uint32_t(bytes[i] == h2) << i;
+        }
+        return result;
+    }
+
+    uint32_t match_empty() const { return match(empty); }
+#endif
+};
+
+// std::hash of integers is the identity: spread all of its bits over the
+// bits that pick the slot and the 7 that go into the control byte
+inline uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 32;
+    hash *= 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+} // namespace serene_hash_detail
+
+// An open-addressing hash map in the style of Swiss tables: a control byte
+// per slot holds 7 bits of the key's hash, and a lookup compares a whole
+// group of 16 control bytes at once, touching the keys only on a match.
+//
+// Slots are probed linearly from the key's home slot. Erasing shifts the
+// following entries of the run back instead of leaving a tombstone, so
+// lookups never get slower after many erases and a lookup stops at the
+// first empty slot.
+//
+// The control bytes and the slots are two VectorTheSerenes, so the map
+// allocates through the same allocator and statistics hooks. The number of
+// slots is a power of two, at most 7/8 of them are used.
+//
+// Like FlatMapTheSerene, dereferencing an iterator gives a pair of
+// references, std::pair<const Key &, T &>. Inserting may rehash and erasing
+// may move other entries, so both invalidate iterators and references.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<Key, T>>>
+class HashMapTheSerene {
+  private:
+    using ctrl_t = serene_hash_detail::ctrl_t;
+    using entry_type = std::pair<Key, T>;
+
+    static_assert(std::is_nothrow_move_constructible_v<entry_type>,
+                  "Rehashing moves entries and can't recover from a throw");
+
+    // Raw room for one entry: the vector allocates the slots, the control
+    // bytes tell which of them hold a live entry
+    struct Slot {
+        alignas(entry_type) std::byte bytes[sizeof(entry_type)];
+    };
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using slot_allocator =
+        typename alloc_traits::template rebind_alloc<Slot>;
+    using ctrl_allocator =
+        typename alloc_traits::template rebind_alloc<ctrl_t>;
+
+    static constexpr size_t group_width = serene_hash_detail::group_width;
+    static constexpr size_t min_capacity = group_width;
+    static constexpr bool relocatable =
+        is_trivially_relocatable_serene_v<Key> &&
+        is_trivially_relocatable_serene_v<T>;
+
+    // capacity() + group_width - 1 control bytes: the last ones mirror the
+    // first ones, so a group starting near the end needs no wraparound
+    VectorTheSerene<ctrl_t, ctrl_allocator> ctrl_;
+    VectorTheSerene<Slot, slot_allocator> slots_;
+    size_t size_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+
+    static size_t max_load(size_t capacity) {
+        return capacity - capacity / 8;
+    }
+
+    static size_t capacity_for(size_t n) {
+        size_t slots = n + (n + 6) / 7;
+        return std::max(min_capacity, std::bit_ceil(slots));
+    }
+
+    size_t mask() const { return slots_.size() - 1; }
+
+    entry_type *entry(size_t index) {
+        return std::launder(
+            reinterpret_cast<entry_type *>(slots_[index].bytes));
+    }
+    const entry_type *entry(size_t index) const {
+        return std::launder(
+            reinterpret_cast<const entry_type *>(slots_[index].bytes));
+    }
+
+    uint64_t hash_of(const Key &key) const {
+        return serene_hash_detail::mix(uint64_t(hash_(key)));
+    }
+    static ctrl_t h2(uint64_t hash) { return ctrl_t(hash & 0x7F); }
+    size_t home(uint64_t hash) const { return size_t(hash >> 7) & mask(); }
+
+    void set_ctrl(size_t index, ctrl_t value) {
+        ctrl_[index] = value;
+        if (index < group_width - 1) {
+            ctrl_[slots_.size() + index] = value;
+        }
+    }
+
+    // Position of key, or capacity() if it isn't there
+    size_t find_index(const Key &key) const {
+        if (size_ == 0) {
+            return slots_.size();
+        }
+        uint64_t hash = hash_of(key);
+        size_t position = home(hash);
+        while (true) {
+            serene_hash_detail::Group group(ctrl_.begin() + position);
+            for (uint32_t bits = group.match(h2(hash)); bits != 0;
+                 bits &= bits - 1) {
+                size_t index = (position + std::countr_zero(bits)) & mask();
+                if (equal_(entry(index)->first, key)) {
+                    return index;
+                }
+            }
+            // Entries are never past an empty slot of their run
+            if (group.match_empty() != 0) {
+                return slots_.size();
+            }
+            position = (position + group_width) & mask();
+        }
+    }
+
+    // The first empty slot at or after the home of hash
+    size_t find_empty(uint64_t hash) const {
+        size_t position = home(hash);
+        while (true) {
+            serene_hash_detail::Group group(ctrl_.begin() + position);
+            uint32_t bits = group.match_empty();
+            if (bits != 0) {
+                return (position + std::countr_zero(bits)) & mask();
+            }
+            position = (position + group_width) & mask();
+        }
+    }
+
+    // Moves the entry at from into the empty slot to
+    void relocate(size_t from, size_t to) {
+        if constexpr (relocatable) {
+            std::memcpy(slots_[to].bytes, slots_[from].bytes,
+                        sizeof(entry_type));
+        } else {
+            ::new (slots_[to].bytes) entry_type(std::move(*entry(from)));
+            entry(from)->~entry_type();
+        }
+    }
+
+    void destroy_all() {
+        if constexpr (!std::is_trivially_destructible_v<entry_type>) {
+            for (size_t i = 0; size_ != 0 && i < slots_.size(); ++i) {
+                if (ctrl_[i] != serene_hash_detail::empty) {
+                    entry(i)->~entry_type();
+                    size_--;
+                }
+            }
+        }
+        size_ = 0;
+    }
+
+    // Moves all the entries into bigger, a table without them, which then
+    // takes the place of this one
+    void move_entries_to(HashMapTheSerene &bigger) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (ctrl_[i] == serene_hash_detail::empty) {
+                continue;
+            }
+            uint64_t hash = hash_of(entry(i)->first);
+            size_t index = bigger.find_empty(hash);
+            bigger.set_ctrl(index, h2(hash));
+            if constexpr (relocatable) {
+                std::memcpy(bigger.slots_[index].bytes, slots_[i].bytes,
+                            sizeof(entry_type));
+            } else {
+                ::new (bigger.slots_[index].bytes)
+                    entry_type(std::move(*entry(i)));
+                entry(i)->~entry_type();
+            }
+        }
+        bigger.size_ += size_;
+        // The entries are gone from here: only the buffers are left to free
+        size_ = 0;
+        swap(bigger);
+    }
+
+    // Moves all the entries into a table with new_capacity slots
+    void rehash(size_t new_capacity) {
+        HashMapTheSerene bigger(hash_, equal_, slots_.get_allocator());
+        bigger.allocate(new_capacity);
+        move_entries_to(bigger);
+    }
+
+    void allocate(size_t capacity) {
+        slots_.resize_uninitialized(capacity);
+        ctrl_.resize(capacity + group_width - 1, serene_hash_detail::empty);
+    }
+
+    // Constructs an entry in the first empty slot for hash, with room left
+    template <typename K, typename... Args>
+    size_t emplace_empty(uint64_t hash, K &&key, Args &&...args) {
+        size_t index = find_empty(hash);
+        ::new (slots_[index].bytes) entry_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        set_ctrl(index, h2(hash));
+        size_++;
+        return index;
+    }
+
+    // Key has to be missing. When the table grows, the entry is built in
+    // the new table before the others move, as key and args may refer to
+    // them, like in m.try_emplace(k, m.at(other))
+    template <typename K, typename... Args>
+    size_t insert_new(K &&key, Args &&...args) {
+        uint64_t hash = hash_of(key);
+        if (size_ + 1 > max_load(slots_.size())) {
+            HashMapTheSerene bigger(hash_, equal_, slots_.get_allocator());
+            bigger.allocate(capacity_for(size_ + 1));
+            size_t index = bigger.emplace_empty(hash, std::forward<K>(key),
+                                                std::forward<Args>(args)...);
+            move_entries_to(bigger);
+            return index;
+        }
+        return emplace_empty(hash, std::forward<K>(key),
+                             std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<size_t, bool> try_emplace_index(K &&key, Args &&...args) {
+        size_t index = find_index(key);
+        if (index != slots_.size()) {
+            return {index, false};
+        }
+        return {insert_new(std::forward<K>(key), std::forward<Args>(args)...),
+                true};
+    }
+
+    // Closes the gap at hole by shifting back the entries after it that
+    // may live there: those whose home is not between hole and themselves
+    void erase_index(size_t hole) {
+        entry(hole)->~entry_type();
+        for (size_t i = (hole + 1) & mask();
+             ctrl_[i] != serene_hash_detail::empty; i = (i + 1) & mask()) {
+            size_t distance = (i - home(hash_of(entry(i)->first))) & mask();
+            if (distance >= ((i - hole) & mask())) {
+                relocate(i, hole);
+                set_ctrl(hole, ctrl_[i]);
+                hole = i;
+            }
+        }
+        set_ctrl(hole, serene_hash_detail::empty);
+        size_--;
+    }
+
+  public:
+    template <bool Const> class Iterator {
+      private:
+        using owner = std::conditional_t<Const, const HashMapTheSerene,
+                                         HashMapTheSerene>;
+
+        owner *map_ = nullptr;
+        size_t index_ = 0;
+
+        void skip_empty() {
+            while (index_ < map_->slots_.size() &&
+                   map_->ctrl_[index_] == serene_hash_detail::empty) {
+                ++index_;
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            std::pair<const Key &, std::conditional_t<Const, const T &, T &>>;
+
+        struct pointer {
+            reference pair;
+            reference *operator->() { return &pair; }
+        };
+
+        Iterator() = default;
+        // Starts at the first entry at or after index
+        Iterator(owner *map, size_t index) : map_(map), index_(index) {
+            skip_empty();
+        }
+        // iterator to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other)
+            : map_(other.map_), index_(other.index_) {}
+
+        reference operator*() const {
+            auto *item = map_->entry(index_);
+            return {item->first, item->second};
+        }
+        pointer operator->() const { return {**this}; }
+
+        Iterator &operator++() {
+            ++index_;
+            skip_empty();
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return index_ == other.index_;
+        }
+
+        template <bool> friend class Iterator;
+        friend class HashMapTheSerene;
+    };
+
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    HashMapTheSerene() = default;
+    explicit HashMapTheSerene(const Hash &hash,
+                              const KeyEqual &equal = KeyEqual(),
+                              const Allocator &alloc = Allocator())
+        : ctrl_(ctrl_allocator(alloc)), slots_(slot_allocator(alloc)),
+          hash_(hash), equal_(equal) {}
+
+    HashMapTheSerene(std::initializer_list<value_type> list) {
+        reserve(list.size());
+        for (const auto &item : list) {
+            insert(item);
+        }
+    }
+
+    HashMapTheSerene(const HashMapTheSerene &other)
+        : HashMapTheSerene(other.hash_, other.equal_,
+                           alloc_traits::select_on_container_copy_construction(
+                               Allocator(other.slots_.get_allocator()))) {
+        reserve(other.size());
+        for (const auto &[key, value] : other) {
+            try_emplace(key, value);
+        }
+    }
+
+    HashMapTheSerene(HashMapTheSerene &&other) noexcept
+        : ctrl_(std::move(other.ctrl_)), slots_(std::move(other.slots_)),
+          size_(std::exchange(other.size_, 0)), hash_(other.hash_),
+          equal_(other.equal_) {}
+
+    HashMapTheSerene &operator=(const HashMapTheSerene &other) {
+        if (this != &other) {
+            HashMapTheSerene copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    HashMapTheSerene &operator=(HashMapTheSerene &&other) noexcept {
+        if (this != &other) {
+            HashMapTheSerene moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~HashMapTheSerene() { destroy_all(); }
+
+    void swap(HashMapTheSerene &other) noexcept {
+        ctrl_.swap(other.ctrl_);
+        slots_.swap(other.slots_);
+        std::swap(size_, other.size_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+    allocator_type get_allocator() const {
+        return Allocator(slots_.get_allocator());
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, slots_.size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, slots_.size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return size_; }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+
+    // Number of slots
+    size_t capacity() const { return slots_.size(); }
+    float load_factor() const {
+        return slots_.size() == 0 ? 0.0f : float(size_) / slots_.size();
+    }
+    static constexpr float max_load_factor() { return 0.875f; }
+
+    // Makes room for n entries without rehashing, keeping the load factor
+    // at or below max_load_factor()
+    void reserve(size_t n) {
+        if (n > max_load(slots_.size())) {
+            rehash(capacity_for(n));
+        }
+    }
+
+    // Keeps the slots
+    void clear() {
+        destroy_all();
+        for (auto &ctrl : ctrl_) {
+            ctrl = serene_hash_detail::empty;
+        }
+    }
+
+    iterator find(const Key &key) { return {this, find_index(key)}; }
+    const_iterator find(const Key &key) const {
+        return {this, find_index(key)};
+    }
+    bool contains(const Key &key) const {
+        return find_index(key) != slots_.size();
+    }
+    size_t count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    T &at(const Key &key) {
+        size_t index = find_index(key);
+        if (index == slots_.size()) {
+            throw std::out_of_range("key not found");
+        }
+        return entry(index)->second;
+    }
+    const T &at(const Key &key) const {
+        size_t index = find_index(key);
+        if (index == slots_.size()) {
+            throw std::out_of_range("key not found");
+        }
+        return entry(index)->second;
+    }
+
+    // Inserts a default-constructed value if key is missing
+    T &operator[](const Key &key) {
+        return entry(try_emplace_index(key).first)->second;
+    }
+    T &operator[](Key &&key) {
+        return entry(try_emplace_index(std::move(key)).first)->second;
+    }
+
+    // Does nothing if key is already there
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+        auto [index, inserted] =
+            try_emplace_index(key, std::forward<Args>(args)...);
+        return {{this, index}, inserted};
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+        auto [index, inserted] =
+            try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {{this, index}, inserted};
+    }
+
+    std::pair<iterator, bool> insert(const value_type &item) {
+        return try_emplace(item.first, item.second);
+    }
+    std::pair<iterator, bool> insert(value_type &&item) {
+        return try_emplace(std::move(item.first), std::move(item.second));
+    }
+
+    template <typename Value>
+    std::pair<iterator, bool> insert_or_assign(const Key &key,
+                                               Value &&value) {
+        size_t index = find_index(key);
+        if (index != slots_.size()) {
+            entry(index)->second = std::forward<Value>(value);
+            return {{this, index}, false};
+        }
+        return {{this, insert_new(key, std::forward<Value>(value))}, true};
+    }
+
+    size_t erase(const Key &key) {
+        size_t index = find_index(key);
+        if (index == slots_.size()) {
+            return 0;
+        }
+        erase_index(index);
+        return 1;
+    }
+
+    // Other entries may move into the freed slot, so there is no iterator
+    // to the next entry to return
+    void erase(const_iterator pos) { erase_index(pos.index_); }
+
+    bool operator==(const HashMapTheSerene &other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        for (const auto &[key, value] : *this) {
+            size_t index = other.find_index(key);
+            if (index == other.slots_.size() ||
+                !(other.entry(index)->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void print_vector(
+    const HashMapTheSerene<Key, T, Hash, KeyEqual, Allocator> &map) {
+    for (const auto &[key, value] : map) {
+        std::cout << key << ":" << value << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_HASH_MAP_THE_SERENE_HPP_
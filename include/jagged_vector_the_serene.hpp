@@ -0,0 +1,337 @@
+#ifndef INCLUDE_JAGGED_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_JAGGED_VECTOR_THE_SERENE_HPP_
+
+#include "./vector_the_serene.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// A vector of variable-length rows in compressed sparse row (CSR) layout:
+// all the rows one after another in a single values buffer, and where each
+// of them starts in an offsets buffer. Replaces
+// VectorTheSerene<VectorTheSerene<T>> with two allocations in total instead
+// of one per row, and makes walking all the rows a linear scan.
+//
+// Only the last row can grow; rows are accessed as std::span.
+template <typename T, typename Allocator = std::allocator<T>>
+class JaggedVectorTheSerene {
+  private:
+    using offset_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<
+            size_t>;
+
+    VectorTheSerene<T, Allocator> values_;
+    // Row i is values_[offsets_[i], offsets_[i + 1]). Empty while there
+    // are no rows, so that empty and moved-from vectors hold no memory;
+    // otherwise starts with a 0.
+    VectorTheSerene<size_t, offset_allocator> offsets_;
+
+    void check_has_rows() const {
+        if (size() == 0) {
+            throw std::out_of_range("no rows");
+        }
+    }
+
+    // erase() refuses empty ranges
+    void truncate_values(size_t new_size) {
+        if (new_size < values_.size()) {
+            values_.erase(values_.begin() + new_size, values_.end());
+        }
+    }
+
+    void add_row_end(size_t end) {
+        if (offsets_.is_empty()) {
+            offsets_.reserve(2);
+            offsets_.push_back(0);
+        }
+        offsets_.push_back(end);
+    }
+
+  public:
+    template <bool Const> class RowIterator {
+      private:
+        using element = std::conditional_t<Const, const T, T>;
+
+        element *values_ = nullptr;
+        const size_t *offset_ = nullptr;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::span<element>;
+        using difference_type = std::ptrdiff_t;
+
+        RowIterator() = default;
+        RowIterator(element *values, const size_t *offset)
+            : values_(values), offset_(offset) {}
+        // iterator to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        RowIterator(const RowIterator<OtherConst> &other)
+            : values_(other.values_), offset_(other.offset_) {}
+
+        std::span<element> operator*() const {
+            return {values_ + offset_[0], values_ + offset_[1]};
+        }
+        std::span<element> operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        RowIterator &operator++() {
+            ++offset_;
+            return *this;
+        }
+        RowIterator operator++(int) {
+            auto old = *this;
+            ++offset_;
+            return old;
+        }
+        RowIterator &operator--() {
+            --offset_;
+            return *this;
+        }
+        RowIterator operator--(int) {
+            auto old = *this;
+            --offset_;
+            return old;
+        }
+        RowIterator &operator+=(difference_type n) {
+            offset_ += n;
+            return *this;
+        }
+        RowIterator &operator-=(difference_type n) {
+            offset_ -= n;
+            return *this;
+        }
+        friend RowIterator operator+(RowIterator it, difference_type n) {
+            return it += n;
+        }
+        friend RowIterator operator+(difference_type n, RowIterator it) {
+            return it += n;
+        }
+        friend RowIterator operator-(RowIterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const RowIterator &a,
+                                         const RowIterator &b) {
+            return a.offset_ - b.offset_;
+        }
+
+        bool operator==(const RowIterator &other) const {
+            return offset_ == other.offset_;
+        }
+        auto operator<=>(const RowIterator &other) const {
+            return offset_ <=> other.offset_;
+        }
+
+        template <bool> friend class RowIterator;
+    };
+
+    using value_type = std::span<T>;
+    using allocator_type = Allocator;
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    JaggedVectorTheSerene() : JaggedVectorTheSerene(Allocator()) {}
+
+    explicit JaggedVectorTheSerene(const Allocator &alloc)
+        : values_(alloc), offsets_(offset_allocator(alloc)) {}
+
+    JaggedVectorTheSerene(
+        std::initializer_list<std::initializer_list<T>> rows,
+        const Allocator &alloc = Allocator())
+        : JaggedVectorTheSerene(alloc) {
+        size_t total = 0;
+        for (const auto &row : rows) {
+            total += row.size();
+        }
+        reserve(rows.size(), total);
+        for (const auto &row : rows) {
+            push_row(row);
+        }
+    }
+
+    // From any range of ranges, e.g. VectorTheSerene<VectorTheSerene<T>>
+    template <std::ranges::input_range Rows>
+        requires std::ranges::input_range<
+                     std::ranges::range_reference_t<Rows>> &&
+                 (!std::is_same_v<std::remove_cvref_t<Rows>,
+                                  JaggedVectorTheSerene>)
+    explicit JaggedVectorTheSerene(Rows &&rows,
+                                   const Allocator &alloc = Allocator())
+        : JaggedVectorTheSerene(alloc) {
+        if constexpr (std::ranges::forward_range<Rows> &&
+                      std::ranges::sized_range<
+                          std::ranges::range_reference_t<Rows>>) {
+            size_t total = 0;
+            size_t count = 0;
+            for (auto &&row : rows) {
+                total += std::ranges::size(row);
+                ++count;
+            }
+            reserve(count, total);
+        }
+        for (auto &&row : rows) {
+            push_row(row);
+        }
+    }
+
+    allocator_type get_allocator() const { return values_.get_allocator(); }
+
+    std::span<T> operator[](size_t row) {
+        return {values_.begin() + offsets_[row],
+                values_.begin() + offsets_[row + 1]};
+    }
+    std::span<const T> operator[](size_t row) const {
+        return {values_.begin() + offsets_[row],
+                values_.begin() + offsets_[row + 1]};
+    }
+
+    std::span<T> at(size_t row) {
+        if (row >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return (*this)[row];
+    }
+    std::span<const T> at(size_t row) const {
+        if (row >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return (*this)[row];
+    }
+
+    std::span<T> front() {
+        check_has_rows();
+        return (*this)[0];
+    }
+    std::span<const T> front() const {
+        check_has_rows();
+        return (*this)[0];
+    }
+    std::span<T> back() {
+        check_has_rows();
+        return (*this)[size() - 1];
+    }
+    std::span<const T> back() const {
+        check_has_rows();
+        return (*this)[size() - 1];
+    }
+
+    // All the rows one after another, e.g. for a pass over every element
+    std::span<T> values() { return {values_.begin(), values_.end()}; }
+    std::span<const T> values() const {
+        return {values_.begin(), values_.end()};
+    }
+
+    // size() + 1 offsets into values(), starting with 0, or none if there
+    // are no rows
+    std::span<const size_t> offsets() const {
+        return {offsets_.begin(), offsets_.end()};
+    }
+
+    iterator begin() { return {values_.begin(), offsets_.begin()}; }
+    iterator end() { return {values_.begin(), offsets_.begin() + size()}; }
+    const_iterator begin() const { return {values_.begin(), offsets_.begin()}; }
+    const_iterator end() const {
+        return {values_.begin(), offsets_.begin() + size()};
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // Number of rows
+    size_t size() const {
+        return offsets_.is_empty() ? 0 : offsets_.size() - 1;
+    }
+    // Number of elements in all the rows
+    size_t total_size() const { return values_.size(); }
+    size_t row_size(size_t row) const {
+        return offsets_[row + 1] - offsets_[row];
+    }
+    bool is_empty() const { return size() == 0; }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t rows, size_t total_values) {
+        offsets_.reserve(rows + 1);
+        values_.reserve(total_values);
+    }
+
+    void clear() {
+        values_.clear();
+        offsets_.clear();
+    }
+
+    void shrink_to_fit() {
+        values_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+    }
+
+    // Starts a new, empty row
+    void push_row() { add_row_end(values_.size()); }
+
+    // Adds a copy of any range as the last row
+    template <std::ranges::input_range Row> void push_row(Row &&row) {
+        size_t old_size = values_.size();
+        values_.append_range(std::forward<Row>(row));
+        try {
+            add_row_end(values_.size());
+        } catch (...) {
+            truncate_values(old_size);
+            throw;
+        }
+    }
+
+    void push_row(std::initializer_list<T> row) {
+        push_row(std::span<const T>(row.begin(), row.size()));
+    }
+
+    void pop_row() {
+        check_has_rows();
+        offsets_.pop_back();
+        truncate_values(offsets_.back());
+        if (offsets_.size() == 1) {
+            offsets_.clear();
+        }
+    }
+
+    // Appends to the last row, which has to exist
+    void push_to_last_row(const T &value) { emplace_to_last_row(value); }
+    void push_to_last_row(T &&value) { emplace_to_last_row(std::move(value)); }
+
+    template <typename... Args> T &emplace_to_last_row(Args &&...args) {
+        check_has_rows();
+        T &item = values_.emplace_back(std::forward<Args>(args)...);
+        offsets_.back() = values_.size();
+        return item;
+    }
+
+    void pop_from_last_row() {
+        check_has_rows();
+        if (offsets_.back() == offsets_[offsets_.size() - 2]) {
+            throw std::out_of_range("the last row is empty");
+        }
+        values_.pop_back();
+        offsets_.back() = values_.size();
+    }
+
+    bool operator==(const JaggedVectorTheSerene &other) const {
+        return offsets_ == other.offsets_ && values_ == other.values_;
+    }
+};
+
+template <typename T, typename Allocator>
+void print_vector(const JaggedVectorTheSerene<T, Allocator> &v) {
+    for (auto row : v) {
+        for (const auto &item : row) {
+            std::cout << item << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+#endif // INCLUDE_JAGGED_VECTOR_THE_SERENE_HPP_
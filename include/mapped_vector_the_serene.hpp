@@ -0,0 +1,397 @@
+#ifndef INCLUDE_MAPPED_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_MAPPED_VECTOR_THE_SERENE_HPP_
+
+#include "./growth_policies.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class MapMode {
+    read_only,  // Existing file, modifications throw, see below
+    read_write, // Existing or new file, keeps the contents
+    truncate    // Existing or new file, starts empty
+};
+
+enum class MapAccess { normal, sequential, random, will_need, dont_need };
+
+// A vector of trivially copyable records that lives in a file: the file is
+// mapped with mmap, so opening it is instant no matter how big it is, and
+// the kernel pages records in and out as needed, so it may be bigger than
+// RAM. The file holds the raw records and nothing else.
+//
+// The file grows with ftruncate to the capacity when records are added,
+// and is cut back to size() records by close() and the destructor; opening
+// it leaves its length alone. Changes reach the file when the kernel writes
+// the pages back, or on sync().
+//
+// A read-only file is mapped copy-on-write, so it has the same element
+// access: records can be changed in memory, but nothing reaches the file.
+// The modifiers that add or remove records throw std::logic_error.
+template <typename T, typename GrowthPolicy = DoublingGrowth<>>
+class MappedVectorTheSerene {
+  private:
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable types can be stored in a file");
+
+    int fd_ = -1;
+    bool writable_ = false;
+    size_t size_ = 0;
+    // In elements, always the whole mapping
+    size_t capacity_ = 0;
+    // nullptr while capacity_ == 0, as empty files can't be mapped
+    T *data_ = nullptr;
+
+    [[noreturn]] static void throw_errno(const char *what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static size_t page_size() {
+        static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    // A grown mapping is whole pages, so is the capacity
+    static size_t round_to_pages(size_t n) {
+        size_t bytes = (n * sizeof(T) + page_size() - 1) & ~(page_size() - 1);
+        return bytes / sizeof(T);
+    }
+
+    void check_writable() const {
+        if (!writable_) {
+            throw std::logic_error("the file is mapped read-only");
+        }
+    }
+
+    void map(size_t capacity) {
+        void *p = mmap(nullptr, capacity * sizeof(T), PROT_READ | PROT_WRITE,
+                       writable_ ? MAP_SHARED : MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) {
+            throw_errno("mmap");
+        }
+        data_ = static_cast<T *>(p);
+        capacity_ = capacity;
+    }
+
+    void unmap() {
+        if (data_ != nullptr) {
+            munmap(data_, capacity_ * sizeof(T));
+            data_ = nullptr;
+        }
+        capacity_ = 0;
+    }
+
+    void truncate_file(size_t n) {
+        if (ftruncate(fd_, off_t(n * sizeof(T))) != 0) {
+            throw_errno("ftruncate");
+        }
+    }
+
+    // Grows the file first, then the mapping over it
+    void remap(size_t new_capacity) {
+        new_capacity = round_to_pages(new_capacity);
+        if (new_capacity == capacity_) {
+            return;
+        }
+        truncate_file(new_capacity);
+        if (data_ == nullptr) {
+            map(new_capacity);
+            return;
+        }
+#ifdef __linux__
+        void *p = mremap(data_, capacity_ * sizeof(T),
+                         new_capacity * sizeof(T), MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            throw_errno("mremap");
+        }
+        data_ = static_cast<T *>(p);
+        capacity_ = new_capacity;
+#else
+        unmap();
+        map(new_capacity);
+#endif
+    }
+
+    size_t capacity_for(size_t new_size) const {
+        if (new_size <= capacity_) {
+            return capacity_;
+        }
+        return GrowthPolicy::next_capacity(capacity_, new_size, sizeof(T));
+    }
+
+  public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<T *>;
+    using const_reverse_iterator = std::reverse_iterator<const T *>;
+
+    MappedVectorTheSerene() = default;
+
+    explicit MappedVectorTheSerene(const std::string &path,
+                                   MapMode mode = MapMode::read_write) {
+        open(path, mode);
+    }
+
+    MappedVectorTheSerene(const MappedVectorTheSerene &) = delete;
+    MappedVectorTheSerene &operator=(const MappedVectorTheSerene &) = delete;
+
+    MappedVectorTheSerene(MappedVectorTheSerene &&other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          writable_(std::exchange(other.writable_, false)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          data_(std::exchange(other.data_, nullptr)) {}
+
+    MappedVectorTheSerene &operator=(MappedVectorTheSerene &&other) noexcept {
+        if (this != &other) {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+            writable_ = std::exchange(other.writable_, false);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            data_ = std::exchange(other.data_, nullptr);
+        }
+        return *this;
+    }
+
+    ~MappedVectorTheSerene() { close(); }
+
+    // Maps the file at path, closing the current one first. The size is the
+    // file size in records; a trailing partial record is an error.
+    void open(const std::string &path, MapMode mode = MapMode::read_write) {
+        close();
+        int flags = O_RDONLY;
+        if (mode == MapMode::read_write) {
+            flags = O_RDWR | O_CREAT;
+        } else if (mode == MapMode::truncate) {
+            flags = O_RDWR | O_CREAT | O_TRUNC;
+        }
+        fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw_errno("open");
+        }
+        writable_ = mode != MapMode::read_only;
+        try {
+            struct stat info {};
+            if (fstat(fd_, &info) != 0) {
+                throw_errno("fstat");
+            }
+            if (size_t(info.st_size) % sizeof(T) != 0) {
+                throw std::runtime_error(
+                    "file size is not a multiple of the record size");
+            }
+            size_t count = size_t(info.st_size) / sizeof(T);
+            // Exactly the records, so that a crash before close() leaves
+            // no unused capacity in the file to be read back as records
+            if (count != 0) {
+                map(count);
+            }
+            size_ = count;
+        } catch (...) {
+            unmap();
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+    }
+
+    // Unmaps the file and cuts it back to size() records
+    void close() noexcept {
+        if (fd_ < 0) {
+            return;
+        }
+        unmap();
+        if (writable_) {
+            // Nothing sensible to do about a failure in a destructor; the
+            // records are all there, just followed by the unused capacity
+            [[maybe_unused]] int result =
+                ftruncate(fd_, off_t(size_ * sizeof(T)));
+        }
+        ::close(fd_);
+        fd_ = -1;
+        size_ = 0;
+        writable_ = false;
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+
+    // Writes the dirty pages to the file, waiting for it unless wait is
+    // false
+    void sync(bool wait = true) {
+        if (data_ != nullptr &&
+            msync(data_, capacity_ * sizeof(T), wait ? MS_SYNC : MS_ASYNC) !=
+                0) {
+            throw_errno("msync");
+        }
+    }
+
+    // Tells the kernel how the records will be accessed, e.g. sequential for
+    // a full scan (aggressive read-ahead) or random for lookups (none)
+    void advise(MapAccess access) {
+        if (data_ == nullptr) {
+            return;
+        }
+        int advice = MADV_NORMAL;
+        switch (access) {
+        case MapAccess::normal:
+            advice = MADV_NORMAL;
+            break;
+        case MapAccess::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case MapAccess::random:
+            advice = MADV_RANDOM;
+            break;
+        case MapAccess::will_need:
+            advice = MADV_WILLNEED;
+            break;
+        case MapAccess::dont_need:
+            advice = MADV_DONTNEED;
+            break;
+        }
+        if (madvise(data_, capacity_ * sizeof(T), advice) != 0) {
+            throw_errno("madvise");
+        }
+    }
+
+    T &operator[](size_t index) { return data_[index]; }
+    const T &operator[](size_t index) const { return data_[index]; }
+
+    T &at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return data_[index];
+    }
+    const T &at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return data_[index];
+    }
+
+    T &front() {
+        if (size_ == 0) {
+            throw std::out_of_range("front() called on empty vector");
+        }
+        return data_[0];
+    }
+    const T &front() const {
+        if (size_ == 0) {
+            throw std::out_of_range("front() called on empty vector");
+        }
+        return data_[0];
+    }
+
+    T &back() {
+        if (size_ == 0) {
+            throw std::out_of_range("back() called on empty vector");
+        }
+        return data_[size_ - 1];
+    }
+    const T &back() const {
+        if (size_ == 0) {
+            throw std::out_of_range("back() called on empty vector");
+        }
+        return data_[size_ - 1];
+    }
+
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    const_iterator cbegin() const { return data_; }
+    const_iterator cend() const { return data_ + size_; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+
+    void reserve(size_t new_capacity) {
+        check_writable();
+        if (new_capacity > capacity_) {
+            remap(new_capacity);
+        }
+    }
+
+    // Gives the unused capacity back to the file system
+    void shrink_to_fit() {
+        check_writable();
+        if (size_ == 0) {
+            unmap();
+            truncate_file(0);
+            return;
+        }
+        remap(size_);
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        check_writable();
+        if (size_ == capacity_) {
+            // The value may live in the mapping that is about to move
+            T item(std::forward<Args>(args)...);
+            remap(capacity_for(size_ + 1));
+            data_[size_] = item;
+        } else {
+            ::new (static_cast<void *>(data_ + size_))
+                T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void pop_back() {
+        check_writable();
+        if (size_ > 0) {
+            size_--;
+        }
+    }
+
+    void clear() {
+        check_writable();
+        size_ = 0;
+    }
+
+    // New records are value-initialized
+    void resize(size_t new_size) { resize(new_size, T()); }
+
+    void resize(size_t new_size, const T &value) {
+        check_writable();
+        if (new_size > size_) {
+            T item = value;
+            remap(capacity_for(new_size));
+            std::fill(data_ + size_, data_ + new_size, item);
+        }
+        size_ = new_size;
+    }
+};
+
+#endif
+
+#endif // INCLUDE_MAPPED_VECTOR_THE_SERENE_HPP_
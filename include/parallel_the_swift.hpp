@@ -0,0 +1,437 @@
+#ifndef INCLUDE_PARALLEL_THE_SWIFT_HPP_
+#define INCLUDE_PARALLEL_THE_SWIFT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque of tasks: it pushes
+// and pops its own tasks at the back (the most recent, still in cache) and,
+// when it runs out, steals from the front of the other deques (the oldest,
+// usually the biggest pieces of work). Threads outside the pool share one
+// more deque. Threads waiting for a TaskGroup run tasks instead of blocking,
+// so nested parallelism (as in parallel_sort) can't deadlock.
+class ThreadPoolTheSwift {
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // One per worker, the last one for the threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> queued_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+
+    struct CurrentWorker {
+        const ThreadPoolTheSwift *pool = nullptr;
+        size_t index = 0;
+    };
+
+    static CurrentWorker &current_worker() {
+        thread_local CurrentWorker current;
+        return current;
+    }
+
+    size_t own_queue() const {
+        const auto &current = current_worker();
+        return current.pool == this ? current.index : queues_.size() - 1;
+    }
+
+    std::optional<std::function<void()>> pop(size_t index, bool steal) {
+        auto &queue = *queues_[index];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return std::nullopt;
+        }
+        std::function<void()> task;
+        if (steal) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        } else {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    void work(size_t index) {
+        current_worker() = {this, index};
+        while (true) {
+            if (run_one()) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] {
+                return stop_ || queued_.load(std::memory_order_relaxed) != 0;
+            });
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+  public:
+    // threads is the total parallelism: threads - 1 workers are started, the
+    // thread waiting for the tasks is the last one
+    explicit ThreadPoolTheSwift(
+        size_t threads = std::max(std::thread::hardware_concurrency(), 1u)) {
+        size_t worker_count = std::max(threads, size_t(1)) - 1;
+        for (size_t i = 0; i <= worker_count; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ThreadPoolTheSwift(const ThreadPoolTheSwift &) = delete;
+    ThreadPoolTheSwift &operator=(const ThreadPoolTheSwift &) = delete;
+
+    ~ThreadPoolTheSwift() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    void push(std::function<void()> task) {
+        auto &queue = *queues_[own_queue()];
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_relaxed);
+        // Taking the lock orders this with a worker checking queued_
+        { std::lock_guard lock(sleep_mutex_); }
+        sleep_cv_.notify_one();
+    }
+
+    // Runs one task of the own deque, or else a stolen one. Returns false if
+    // there was nothing to do.
+    bool run_one() {
+        size_t own = own_queue();
+        auto task = pop(own, false);
+        for (size_t i = 1; !task && i < queues_.size(); ++i) {
+            task = pop((own + i) % queues_.size(), true);
+        }
+        if (!task) {
+            return false;
+        }
+        (*task)();
+        return true;
+    }
+};
+
+// The pool the parallel algorithms use unless told otherwise, with one thread
+// per core
+inline ThreadPoolTheSwift &default_thread_pool() {
+    static ThreadPoolTheSwift pool;
+    return pool;
+}
+
+// Tasks that are waited for together. The first exception thrown by a task
+// is rethrown by wait(); the destructor waits as well.
+class TaskGroup {
+  private:
+    ThreadPoolTheSwift &pool_;
+    std::atomic<size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    void help_until_done() {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+  public:
+    explicit TaskGroup(ThreadPoolTheSwift &pool = default_thread_pool())
+        : pool_(pool) {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() { help_until_done(); }
+
+    template <typename F> void run(F &&task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.push([this, task = std::forward<F>(task)]() mutable {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard lock(error_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            // The group may be gone right after this
+            pending_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        help_until_done();
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+};
+
+struct ParallelOptions {
+    // default_thread_pool() if null
+    ThreadPoolTheSwift *pool = nullptr;
+    // Elements per task. 0 picks about four tasks per thread, but no fewer
+    // than min_grain elements each.
+    size_t grain = 0;
+
+    static constexpr size_t min_grain = 2048;
+
+    ThreadPoolTheSwift &get_pool() const {
+        return pool != nullptr ? *pool : default_thread_pool();
+    }
+
+    size_t grain_for(size_t n) const {
+        if (grain != 0) {
+            return grain;
+        }
+        size_t tasks = get_pool().concurrency() * 4;
+        return std::max((n + tasks - 1) / tasks, min_grain);
+    }
+};
+
+namespace parallel_detail {
+
+// Runs chunk(c) for c in [first, last): halves the range, hands the upper
+// half to the pool and keeps going with the lower one, so idle threads steal
+// big pieces and split them further themselves
+template <typename Chunk>
+void split(TaskGroup &group, size_t first, size_t last, const Chunk &chunk) {
+    while (last - first > 1) {
+        size_t middle = first + (last - first) / 2;
+        group.run([&group, middle, last, &chunk] {
+            split(group, middle, last, chunk);
+        });
+        last = middle;
+    }
+    chunk(first);
+}
+
+// Calls body(begin, end) on [0, n) cut into pieces of the grain size, and
+// returns the number of pieces. Piece c is [c * grain, (c + 1) * grain).
+template <typename Body>
+size_t for_chunks(size_t n, const ParallelOptions &options, const Body &body) {
+    if (n == 0) {
+        return 0;
+    }
+    size_t grain = options.grain_for(n);
+    size_t chunks = (n + grain - 1) / grain;
+    auto chunk = [&](size_t c) {
+        body(c * grain, std::min((c + 1) * grain, n), c);
+    };
+    if (chunks == 1 || options.get_pool().concurrency() == 1) {
+        for (size_t c = 0; c < chunks; ++c) {
+            chunk(c);
+        }
+        return chunks;
+    }
+    TaskGroup group(options.get_pool());
+    split(group, 0, chunks, chunk);
+    group.wait();
+    return chunks;
+}
+
+template <typename Iterator, typename Compare>
+void sort(TaskGroup &group, Iterator first, Iterator last, Compare &compare,
+          size_t grain, size_t depth) {
+    while (size_t(last - first) > grain) {
+        if (depth-- == 0) {
+            // Bad pivots, don't risk quadratic time
+            std::sort(first, last, compare);
+            return;
+        }
+        auto a = first;
+        auto b = first + (last - first) / 2;
+        auto c = last - 1;
+        // Median of three
+        if (compare(*b, *a)) {
+            std::swap(a, b);
+        }
+        if (compare(*c, *b)) {
+            b = compare(*c, *a) ? a : c;
+        }
+        auto pivot = *b;
+        // Three-way, so runs of equal keys are done in one step
+        auto lower = std::partition(
+            first, last, [&](const auto &x) { return compare(x, pivot); });
+        auto upper = std::partition(
+            lower, last, [&](const auto &x) { return !compare(pivot, x); });
+        group.run([&group, upper, last, &compare, grain, depth] {
+            sort(group, upper, last, compare, grain, depth);
+        });
+        last = lower;
+    }
+    std::sort(first, last, compare);
+}
+
+} // namespace parallel_detail
+
+// Calls body(i) for every i in [first, last), in parallel and in no
+// particular order
+template <typename Body>
+void parallel_for(size_t first, size_t last, Body body,
+                  const ParallelOptions &options = {}) {
+    if (last <= first) {
+        return;
+    }
+    parallel_detail::for_chunks(
+        last - first, options, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = first + begin; i < first + end; ++i) {
+                body(i);
+            }
+        });
+}
+
+template <std::ranges::random_access_range Range, typename T>
+void parallel_fill(Range &&range, const T &value,
+                   const ParallelOptions &options = {}) {
+    auto first = std::ranges::begin(range);
+    parallel_detail::for_chunks(
+        size_t(std::ranges::distance(range)), options,
+        [&](size_t begin, size_t end, size_t) {
+            std::fill(first + begin, first + end, value);
+        });
+}
+
+// Like vector.resize(n, value), but the new elements are written by the
+// pool. Takes a vector with resize_uninitialized(), such as VectorTheSerene,
+// of trivially copyable elements, whose copies can't throw; for anything
+// else it is a plain resize. Pays off for buffers of a few MiB and up.
+template <typename Vector, typename T>
+void parallel_resize(Vector &vector, size_t n, const T &value,
+                     const ParallelOptions &options = {}) {
+    using Element = std::ranges::range_value_t<Vector>;
+    if constexpr (std::is_trivially_copyable_v<Element> &&
+                  requires { vector.resize_uninitialized(n); }) {
+        size_t old_size = vector.size();
+        // value may live in the vector, which is about to move
+        const Element copy = value;
+        vector.resize_uninitialized(n);
+        if (old_size < n) {
+            parallel_fill(std::ranges::subrange(vector.begin() + old_size,
+                                                vector.end()),
+                          copy, options);
+        }
+    } else {
+        vector.resize(n, value);
+    }
+}
+
+// Like std::copy: dest has to have room for the whole range. Returns the end
+// of the copy.
+template <std::ranges::random_access_range Range,
+          std::random_access_iterator Output>
+Output parallel_copy(const Range &range, Output dest,
+                     const ParallelOptions &options = {}) {
+    auto first = std::ranges::begin(range);
+    size_t n = size_t(std::ranges::distance(range));
+    parallel_detail::for_chunks(n, options,
+                                [&](size_t begin, size_t end, size_t) {
+                                    std::copy(first + begin, first + end,
+                                              dest + begin);
+                                });
+    return dest + n;
+}
+
+// Like std::transform. dest may be the beginning of the range itself.
+template <std::ranges::random_access_range Range,
+          std::random_access_iterator Output, typename Function>
+Output parallel_transform(const Range &range, Output dest, Function function,
+                          const ParallelOptions &options = {}) {
+    auto first = std::ranges::begin(range);
+    size_t n = size_t(std::ranges::distance(range));
+    parallel_detail::for_chunks(n, options,
+                                [&](size_t begin, size_t end, size_t) {
+                                    std::transform(first + begin, first + end,
+                                                   dest + begin, function);
+                                });
+    return dest + n;
+}
+
+// Like std::reduce: op has to be associative. The pieces are combined in
+// order, so the result does not depend on the thread count for a fixed
+// grain.
+template <std::ranges::random_access_range Range, typename T,
+          typename Op = std::plus<>>
+T parallel_reduce(const Range &range, T init, Op op = {},
+                  const ParallelOptions &options = {}) {
+    auto first = std::ranges::begin(range);
+    size_t n = size_t(std::ranges::distance(range));
+    if (n == 0) {
+        return init;
+    }
+    size_t grain = options.grain_for(n);
+    std::vector<std::optional<T>> partial((n + grain - 1) / grain);
+    ParallelOptions fixed = options;
+    fixed.grain = grain;
+    parallel_detail::for_chunks(
+        n, fixed, [&](size_t begin, size_t end, size_t c) {
+            T sum = first[begin];
+            for (size_t i = begin + 1; i < end; ++i) {
+                sum = op(std::move(sum), first[i]);
+            }
+            partial[c].emplace(std::move(sum));
+        });
+    for (auto &sum : partial) {
+        init = op(std::move(init), std::move(*sum));
+    }
+    return init;
+}
+
+// Parallel quicksort: every partition step hands one side to the pool, pieces
+// of at most the grain size are finished with std::sort. Not stable.
+template <std::ranges::random_access_range Range,
+          typename Compare = std::less<>>
+void parallel_sort(Range &&range, Compare compare = {},
+                   const ParallelOptions &options = {}) {
+    auto first = std::ranges::begin(range);
+    auto last = std::ranges::end(range);
+    size_t n = size_t(last - first);
+    size_t grain = options.grain_for(n);
+    if (n <= grain || options.get_pool().concurrency() == 1) {
+        std::sort(first, last, compare);
+        return;
+    }
+    TaskGroup group(options.get_pool());
+    parallel_detail::sort(group, first, last, compare, grain,
+                          2 * size_t(std::bit_width(n)));
+    group.wait();
+}
+
+#endif // INCLUDE_PARALLEL_THE_SWIFT_HPP_
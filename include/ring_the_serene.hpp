@@ -0,0 +1,498 @@
+#ifndef INCLUDE_RING_THE_SERENE_HPP_
+#define INCLUDE_RING_THE_SERENE_HPP_
+
+#include "./growth_policies.hpp"
+#include "./serene_checks.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+enum class RingMode {
+    grow,            // A full ring reallocates, like a vector
+    overwrite_oldest // A full ring drops the element at the other end
+};
+
+// A circular buffer: the elements occupy a contiguous run of slots that may
+// wrap around the end of the buffer, so pushing and popping at either end
+// is O(1) and never shifts anything, unlike erase(begin()) on a vector.
+//
+// The contents are at most two contiguous pieces, returned by segments(),
+// e.g. for a single writev() call, after which pop_front(n) drops what was
+// written.
+//
+// In RingMode::overwrite_oldest the capacity stays fixed and a push into a
+// full ring replaces the element at the opposite end, e.g. to keep the last
+// N samples of a telemetry stream.
+template <typename T, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth<>>
+class RingTheSerene {
+  private:
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "Growing moves elements and can't recover from a throw");
+
+    // Raw room for one element: the vector allocates the buffer, head_ and
+    // size_ tell which slots hold a live element
+    struct Slot {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using slot_allocator =
+        typename alloc_traits::template rebind_alloc<Slot>;
+
+    VectorTheSerene<Slot, slot_allocator> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    RingMode mode_ = RingMode::grow;
+
+    // Slot of the element at index, without a division
+    size_t physical(size_t index) const {
+        size_t position = head_ + index;
+        return position >= slots_.size() ? position - slots_.size()
+                                         : position;
+    }
+
+    T *slot(size_t index) {
+        return std::launder(
+            reinterpret_cast<T *>(slots_[physical(index)].bytes));
+    }
+    const T *slot(size_t index) const {
+        return std::launder(
+            reinterpret_cast<const T *>(slots_[physical(index)].bytes));
+    }
+
+    // Exactly n slots, without the minimum capacity of the growth policy
+    static void allocate(VectorTheSerene<Slot, slot_allocator> &slots,
+                         size_t n) {
+        slots.reserve(n);
+        slots.resize_uninitialized(n);
+    }
+
+    // Moves the elements to the start of bigger, which takes the place of
+    // the buffer
+    void relocate_into(VectorTheSerene<Slot, slot_allocator> &bigger) {
+        auto [first, second] = segments();
+        if constexpr (is_trivially_relocatable_serene_v<T>) {
+            if (!first.empty()) {
+                std::memcpy(bigger.begin(), first.data(),
+                            first.size() * sizeof(T));
+            }
+            if (!second.empty()) {
+                std::memcpy(bigger.begin() + first.size(), second.data(),
+                            second.size() * sizeof(T));
+            }
+        } else {
+            for (size_t i = 0; i < size_; ++i) {
+                ::new (bigger[i].bytes) T(std::move(*slot(i)));
+                slot(i)->~T();
+            }
+        }
+        slots_.swap(bigger);
+        head_ = 0;
+    }
+
+    void relocate_to(size_t new_capacity) {
+        VectorTheSerene<Slot, slot_allocator> bigger(
+            slots_.get_allocator());
+        allocate(bigger, new_capacity);
+        relocate_into(bigger);
+    }
+
+    // A push into a full ring. The new element is built before anything is
+    // moved or dropped, as args may refer to an element of the ring, like
+    // in r.push_back(r.front())
+    template <typename... Args>
+    T &emplace_into_full(bool at_back, Args &&...args) {
+        if (mode_ == RingMode::overwrite_oldest) {
+            T item(std::forward<Args>(args)...);
+            if (at_back) {
+                pop_front();
+                return emplace_back(std::move(item));
+            }
+            pop_back();
+            return emplace_front(std::move(item));
+        }
+        VectorTheSerene<Slot, slot_allocator> bigger(
+            slots_.get_allocator());
+        allocate(bigger, GrowthPolicy::next_capacity(slots_.size(),
+                                                     size_ + 1, sizeof(T)));
+        // The elements move to the start of bigger, so a new front goes
+        // into its last slot
+        size_t position = at_back ? size_ : bigger.size() - 1;
+        T *where = ::new (static_cast<void *>(bigger[position].bytes))
+            T(std::forward<Args>(args)...);
+        relocate_into(bigger);
+        if (!at_back) {
+            head_ = position;
+        }
+        size_++;
+        return *where;
+    }
+
+    void destroy_all() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < size_; ++i) {
+                slot(i)->~T();
+            }
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // For constructors: the destructor won't run if a copy throws
+    template <typename Range> void append_all(const Range &range) {
+        try {
+            for (const auto &item : range) {
+                push_back(item);
+            }
+        } catch (...) {
+            destroy_all();
+            throw;
+        }
+    }
+
+  public:
+    template <bool Const> class Iterator {
+      private:
+        using owner =
+            std::conditional_t<Const, const RingTheSerene, RingTheSerene>;
+
+        owner *ring_ = nullptr;
+        size_t index_ = 0;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T &, T &>;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+
+        Iterator() = default;
+        Iterator(owner *ring, size_t index) : ring_(ring), index_(index) {}
+        // iterator to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other)
+            : ring_(other.ring_), index_(other.index_) {}
+
+        reference operator*() const { return *ring_->slot(index_); }
+        pointer operator->() const { return ring_->slot(index_); }
+        reference operator[](difference_type n) const {
+            return *ring_->slot(index_ + n);
+        }
+
+        Iterator &operator++() {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator &operator--() {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+        Iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a,
+                                         const Iterator &b) {
+            return difference_type(a.index_) - difference_type(b.index_);
+        }
+
+        bool operator==(const Iterator &other) const {
+            return index_ == other.index_;
+        }
+        auto operator<=>(const Iterator &other) const {
+            return index_ <=> other.index_;
+        }
+
+        template <bool> friend class Iterator;
+    };
+
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    RingTheSerene() = default;
+    explicit RingTheSerene(const Allocator &alloc)
+        : slots_(slot_allocator(alloc)) {}
+
+    // Room for capacity elements up front; required to be positive in
+    // RingMode::overwrite_oldest, where it never changes
+    RingTheSerene(size_t capacity, RingMode mode,
+                  const Allocator &alloc = Allocator())
+        : slots_(slot_allocator(alloc)), mode_(mode) {
+        if (mode == RingMode::overwrite_oldest && capacity == 0) {
+            throw std::invalid_argument("overwriting ring needs capacity");
+        }
+        allocate(slots_, capacity);
+    }
+
+    RingTheSerene(std::initializer_list<T> list,
+                  const Allocator &alloc = Allocator())
+        : slots_(slot_allocator(alloc)) {
+        reserve(list.size());
+        append_all(list);
+    }
+
+    RingTheSerene(const RingTheSerene &other)
+        : slots_(slot_allocator(
+              alloc_traits::select_on_container_copy_construction(
+                  Allocator(other.slots_.get_allocator())))),
+          mode_(other.mode_) {
+        allocate(slots_, other.capacity());
+        append_all(other);
+    }
+
+    RingTheSerene(RingTheSerene &&other) noexcept
+        : slots_(std::move(other.slots_)),
+          head_(std::exchange(other.head_, 0)),
+          size_(std::exchange(other.size_, 0)), mode_(other.mode_) {}
+
+    RingTheSerene &operator=(const RingTheSerene &other) {
+        if (this != &other) {
+            RingTheSerene copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    RingTheSerene &operator=(RingTheSerene &&other) noexcept {
+        if (this != &other) {
+            RingTheSerene moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~RingTheSerene() { destroy_all(); }
+
+    void swap(RingTheSerene &other) noexcept {
+        slots_.swap(other.slots_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+        std::swap(mode_, other.mode_);
+    }
+
+    allocator_type get_allocator() const {
+        return Allocator(slots_.get_allocator());
+    }
+
+    RingMode mode() const { return mode_; }
+
+    // Only checked at the hardened and assert levels, see serene_checks.hpp
+    T &operator[](size_t index) {
+        serene_check_index(index < size_);
+        return *slot(index);
+    }
+    const T &operator[](size_t index) const {
+        serene_check_index(index < size_);
+        return *slot(index);
+    }
+
+    T &at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return *slot(index);
+    }
+    const T &at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return *slot(index);
+    }
+
+    T &front() {
+        serene_check(size_ != 0, "ring is empty");
+        return *slot(0);
+    }
+    const T &front() const {
+        serene_check(size_ != 0, "ring is empty");
+        return *slot(0);
+    }
+    T &back() {
+        serene_check(size_ != 0, "ring is empty");
+        return *slot(size_ - 1);
+    }
+    const T &back() const {
+        serene_check(size_ != 0, "ring is empty");
+        return *slot(size_ - 1);
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size_}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    // The elements in order as two contiguous pieces; the second one is
+    // empty unless the elements wrap around the end of the buffer
+    std::pair<std::span<T>, std::span<T>> segments() {
+        if (size_ == 0) {
+            return {};
+        }
+        T *base = std::launder(reinterpret_cast<T *>(slots_.begin()));
+        size_t first = std::min(size_, slots_.size() - head_);
+        return {{base + head_, first}, {base, size_ - first}};
+    }
+    std::pair<std::span<const T>, std::span<const T>> segments() const {
+        if (size_ == 0) {
+            return {};
+        }
+        const T *base =
+            std::launder(reinterpret_cast<const T *>(slots_.begin()));
+        size_t first = std::min(size_, slots_.size() - head_);
+        return {{base + head_, first}, {base, size_ - first}};
+    }
+
+    // Moves the elements to the start of the buffer if they wrap around,
+    // so that they are a single span
+    std::span<T> make_contiguous() {
+        if (head_ + size_ > slots_.size()) {
+            relocate_to(slots_.size());
+        }
+        return segments().first;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+    bool is_full() const { return size_ == slots_.size(); }
+
+    // Also widens the window of an overwriting ring
+    void reserve(size_t n) {
+        if (n > slots_.size()) {
+            relocate_to(n);
+        }
+    }
+
+    // Frees the unused slots of a growing ring
+    void shrink_to_fit() {
+        if (mode_ == RingMode::grow && size_ < slots_.size()) {
+            relocate_to(size_);
+        }
+    }
+
+    // The members are read into locals before the element is constructed:
+    // storing a T may alias them as far as the compiler knows
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        if (size_ == slots_.size()) [[unlikely]] {
+            return emplace_into_full(true, std::forward<Args>(args)...);
+        }
+        size_t size = size_;
+        T *where = std::launder(
+            reinterpret_cast<T *>(slots_[physical(size)].bytes));
+        ::new (static_cast<void *>(where)) T(std::forward<Args>(args)...);
+        size_ = size + 1;
+        return *where;
+    }
+
+    template <typename... Args> T &emplace_front(Args &&...args) {
+        if (size_ == slots_.size()) [[unlikely]] {
+            return emplace_into_full(false, std::forward<Args>(args)...);
+        }
+        size_t size = size_;
+        size_t position = head_ == 0 ? slots_.size() - 1 : head_ - 1;
+        T *where =
+            std::launder(reinterpret_cast<T *>(slots_[position].bytes));
+        ::new (static_cast<void *>(where)) T(std::forward<Args>(args)...);
+        head_ = position;
+        size_ = size + 1;
+        return *where;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+    void push_front(const T &value) { emplace_front(value); }
+    void push_front(T &&value) { emplace_front(std::move(value)); }
+
+    void pop_front() {
+        serene_check(size_ != 0, "ring is empty");
+        slot(0)->~T();
+        head_ = physical(1);
+        size_--;
+    }
+
+    // Drops the first count elements, e.g. what a writev() consumed
+    void pop_front(size_t count) {
+        serene_check(count <= size_, "ring is too short");
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < count; ++i) {
+                slot(i)->~T();
+            }
+        }
+        head_ = physical(count);
+        size_ -= count;
+    }
+
+    void pop_back() {
+        serene_check(size_ != 0, "ring is empty");
+        slot(size_ - 1)->~T();
+        size_--;
+    }
+
+    // Keeps the buffer
+    void clear() { destroy_all(); }
+
+    bool operator==(const RingTheSerene &other) const {
+        return size_ == other.size_ &&
+               std::equal(begin(), end(), other.begin());
+    }
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void print_vector(const RingTheSerene<T, Allocator, GrowthPolicy> &ring) {
+    for (const auto &item : ring) {
+        std::cout << item << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_RING_THE_SERENE_HPP_
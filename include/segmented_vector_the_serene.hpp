@@ -0,0 +1,481 @@
+#ifndef INCLUDE_SEGMENTED_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_SEGMENTED_VECTOR_THE_SERENE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// A double-ended vector whose elements never move: they live in blocks of
+// 16, 32, 64, ... elements that are allocated as the vector grows and are
+// never reallocated, so pointers and references to elements stay valid
+// until the element itself is removed, and growing never copies anything.
+//
+// The front and the back grow separately, each through its own series of
+// blocks, so push_front and push_back are both O(1). Indexing finds the
+// block by counting leading zeros of the index, so it is O(1) as well.
+//
+// Blocks are kept after pops for reuse; shrink_to_fit() frees the unused
+// ones. Used as a queue, the memory follows the number of elements, not
+// the number of pushes (see Half).
+template <typename T, typename Allocator = std::allocator<T>>
+class SegmentedVectorTheSerene {
+  private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    static constexpr size_t first_block_bits = 4;
+    static constexpr size_t first_block_size = size_t(1)
+                                               << first_block_bits;
+    // Enough for any index that fits into size_t
+    static constexpr size_t block_count =
+        std::numeric_limits<size_t>::digits - first_block_bits;
+
+    struct Position {
+        size_t block;
+        size_t offset;
+    };
+
+    // Block b holds first_block_size << b elements, so the index shifted by
+    // first_block_size has its highest bit at b + first_block_bits
+    static Position locate(size_t index) {
+        size_t shifted = index + first_block_size;
+        size_t high_bit = size_t(std::numeric_limits<size_t>::digits - 1 -
+                                 std::countl_zero(shifted));
+        return {high_bit - first_block_bits,
+                shifted ^ (size_t(1) << high_bit)};
+    }
+
+    static size_t block_size(size_t block) {
+        return first_block_size << block;
+    }
+
+    // Elements [lo, hi) of a series of blocks
+    struct Run {
+        std::array<T *, block_count> blocks{};
+        size_t lo = 0;
+        size_t hi = 0;
+
+        size_t size() const { return hi - lo; }
+
+        T *at(size_t index) const {
+            Position position = locate(index);
+            return blocks[position.block] + position.offset;
+        }
+    };
+
+    // One end of the vector, which grows at the hi end of a run. The
+    // front half grows at hi as well, that is its end closest to the front
+    // of the vector.
+    //
+    // Used as a queue, a half is pushed at hi and popped at lo, so lo keeps
+    // rising and the blocks would get ever bigger. Once lo has passed more
+    // slots than there are elements, pushes go to the other run, which
+    // starts again from its first block, and the old run only drains.
+    // The indices, and thus the blocks, stay proportional to the size.
+    struct Half {
+        Run runs[2];
+        // The run pushed at; the other one holds the older elements
+        size_t growing = 0;
+
+        Run &newer() { return runs[growing]; }
+        const Run &newer() const { return runs[growing]; }
+        Run &older() { return runs[growing ^ 1]; }
+        const Run &older() const { return runs[growing ^ 1]; }
+
+        size_t size() const { return runs[0].size() + runs[1].size(); }
+
+        // The element at position from the lo end
+        T *at(size_t position) const {
+            const Run &old = older();
+            if (position < old.size()) {
+                return old.at(old.lo + position);
+            }
+            const Run &run = newer();
+            return run.at(run.lo + (position - old.size()));
+        }
+
+        // The element at the hi end, taken out of the half
+        T *take_hi() {
+            Run &run = newer().size() != 0 ? newer() : older();
+            return run.at(--run.hi);
+        }
+
+        // The element at the lo end, taken out of the half
+        T *take_lo() {
+            Run &old = older();
+            if (old.size() != 0) {
+                T *item = old.at(old.lo++);
+                if (old.size() == 0) {
+                    old.lo = 0;
+                    old.hi = 0;
+                }
+                return item;
+            }
+            Run &run = newer();
+            T *item = run.at(run.lo++);
+            if (run.lo > run.size()) {
+                // The empty old run takes the pushes from its first block
+                old.lo = 0;
+                old.hi = 0;
+                growing ^= 1;
+            }
+            return item;
+        }
+    };
+
+    [[no_unique_address]] Allocator alloc_;
+    Half front_;
+    Half back_;
+
+    // The slot for the next element of half, allocating its block if needed
+    T *next_slot(Half &half) {
+        Run &run = half.newer();
+        Position position = locate(run.hi);
+        T *&block = run.blocks[position.block];
+        if (block == nullptr) {
+            block = alloc_traits::allocate(alloc_, block_size(position.block));
+        }
+        return block + position.offset;
+    }
+
+    void destroy_half(Half &half) {
+        for (Run &run : half.runs) {
+            for (size_t i = run.lo; i < run.hi; ++i) {
+                alloc_traits::destroy(alloc_, run.at(i));
+            }
+            run.lo = 0;
+            run.hi = 0;
+        }
+    }
+
+    // Frees the blocks outside [lo, hi)
+    void free_blocks(Run &run) {
+        size_t first_used = block_count;
+        size_t last_used = 0;
+        if (run.size() != 0) {
+            first_used = locate(run.lo).block;
+            last_used = locate(run.hi - 1).block;
+        }
+        for (size_t block = 0; block < block_count; ++block) {
+            if ((block < first_used || block > last_used) &&
+                run.blocks[block] != nullptr) {
+                alloc_traits::deallocate(alloc_, run.blocks[block],
+                                         block_size(block));
+                run.blocks[block] = nullptr;
+            }
+        }
+    }
+
+    // An emptied half starts from its first block again
+    static void rewind_if_empty(Half &half) {
+        if (half.size() == 0) {
+            for (Run &run : half.runs) {
+                run.lo = 0;
+                run.hi = 0;
+            }
+        }
+    }
+
+    T *slot(size_t index) const {
+        size_t front_size = front_.size();
+        if (index < front_size) {
+            return front_.at(front_size - 1 - index);
+        }
+        return back_.at(index - front_size);
+    }
+
+    // For constructors: the destructor won't run if a copy throws
+    template <typename Range> void append_all(const Range &range) {
+        try {
+            for (const auto &item : range) {
+                push_back(item);
+            }
+        } catch (...) {
+            clear();
+            shrink_to_fit();
+            throw;
+        }
+    }
+
+    void check_not_empty() const {
+        if (empty()) {
+            throw std::out_of_range("vector is empty");
+        }
+    }
+
+  public:
+    template <bool Const> class Iterator {
+      private:
+        using owner =
+            std::conditional_t<Const, const SegmentedVectorTheSerene,
+                               SegmentedVectorTheSerene>;
+
+        owner *vector_ = nullptr;
+        size_t index_ = 0;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T &, T &>;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+
+        Iterator() = default;
+        Iterator(owner *vector, size_t index)
+            : vector_(vector), index_(index) {}
+        // iterator to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other)
+            : vector_(other.vector_), index_(other.index_) {}
+
+        reference operator*() const { return *vector_->slot(index_); }
+        pointer operator->() const { return vector_->slot(index_); }
+        reference operator[](difference_type n) const {
+            return *vector_->slot(index_ + n);
+        }
+
+        Iterator &operator++() {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator &operator--() {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+        Iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a,
+                                         const Iterator &b) {
+            return difference_type(a.index_) - difference_type(b.index_);
+        }
+
+        bool operator==(const Iterator &other) const {
+            return index_ == other.index_;
+        }
+        auto operator<=>(const Iterator &other) const {
+            return index_ <=> other.index_;
+        }
+
+        template <bool> friend class Iterator;
+    };
+
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SegmentedVectorTheSerene() : SegmentedVectorTheSerene(Allocator()) {}
+    explicit SegmentedVectorTheSerene(const Allocator &alloc)
+        : alloc_(alloc) {}
+
+    SegmentedVectorTheSerene(std::initializer_list<T> list,
+                             const Allocator &alloc = Allocator())
+        : alloc_(alloc) {
+        append_all(list);
+    }
+
+    SegmentedVectorTheSerene(const SegmentedVectorTheSerene &other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              other.alloc_)) {
+        append_all(other);
+    }
+
+    // Takes over the blocks, leaving other empty and allocation-free
+    SegmentedVectorTheSerene(SegmentedVectorTheSerene &&other) noexcept
+        : alloc_(std::move(other.alloc_)),
+          front_(std::exchange(other.front_, Half{})),
+          back_(std::exchange(other.back_, Half{})) {}
+
+    SegmentedVectorTheSerene &
+    operator=(const SegmentedVectorTheSerene &other) {
+        if (this != &other) {
+            SegmentedVectorTheSerene copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SegmentedVectorTheSerene &
+    operator=(SegmentedVectorTheSerene &&other) noexcept {
+        if (this != &other) {
+            SegmentedVectorTheSerene moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~SegmentedVectorTheSerene() {
+        clear();
+        shrink_to_fit();
+    }
+
+    void swap(SegmentedVectorTheSerene &other) noexcept {
+        std::swap(alloc_, other.alloc_);
+        std::swap(front_, other.front_);
+        std::swap(back_, other.back_);
+    }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    T &operator[](size_t index) { return *slot(index); }
+    const T &operator[](size_t index) const { return *slot(index); }
+
+    T &at(size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return *slot(index);
+    }
+    const T &at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return *slot(index);
+    }
+
+    T &front() {
+        check_not_empty();
+        return *slot(0);
+    }
+    const T &front() const {
+        check_not_empty();
+        return *slot(0);
+    }
+    T &back() {
+        check_not_empty();
+        return *slot(size() - 1);
+    }
+    const T &back() const {
+        check_not_empty();
+        return *slot(size() - 1);
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    size_t size() const { return front_.size() + back_.size(); }
+    bool is_empty() const { return size() == 0; }
+    bool empty() const { return size() == 0; }
+
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        T *where = next_slot(back_);
+        alloc_traits::construct(alloc_, where, std::forward<Args>(args)...);
+        back_.newer().hi++;
+        return *where;
+    }
+
+    template <typename... Args> T &emplace_front(Args &&...args) {
+        T *where = next_slot(front_);
+        alloc_traits::construct(alloc_, where, std::forward<Args>(args)...);
+        front_.newer().hi++;
+        return *where;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+    void push_front(const T &value) { emplace_front(value); }
+    void push_front(T &&value) { emplace_front(std::move(value)); }
+
+    // The last element is at the end of the back half, or, if that one is
+    // empty, at the start of the front half
+    void pop_back() {
+        check_not_empty();
+        if (back_.size() != 0) {
+            alloc_traits::destroy(alloc_, back_.take_hi());
+            rewind_if_empty(back_);
+        } else {
+            alloc_traits::destroy(alloc_, front_.take_lo());
+            rewind_if_empty(front_);
+        }
+    }
+
+    void pop_front() {
+        check_not_empty();
+        if (front_.size() != 0) {
+            alloc_traits::destroy(alloc_, front_.take_hi());
+            rewind_if_empty(front_);
+        } else {
+            alloc_traits::destroy(alloc_, back_.take_lo());
+            rewind_if_empty(back_);
+        }
+    }
+
+    // Keeps the blocks for reuse
+    void clear() {
+        destroy_half(front_);
+        destroy_half(back_);
+    }
+
+    // Frees the blocks no element lives in
+    void shrink_to_fit() {
+        for (Half *half : {&front_, &back_}) {
+            for (Run &run : half->runs) {
+                free_blocks(run);
+            }
+        }
+    }
+
+    bool operator==(const SegmentedVectorTheSerene &other) const {
+        return size() == other.size() &&
+               std::equal(begin(), end(), other.begin());
+    }
+};
+
+template <typename T, typename Allocator>
+void print_vector(const SegmentedVectorTheSerene<T, Allocator> &v) {
+    for (const auto &item : v) {
+        std::cout << item << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_SEGMENTED_VECTOR_THE_SERENE_HPP_
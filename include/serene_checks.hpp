@@ -0,0 +1,73 @@
+#ifndef INCLUDE_SERENE_CHECKS_HPP_
+#define INCLUDE_SERENE_CHECKS_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+// How the containers check their preconditions: front() and back() of an
+// empty container, positions passed to insert() and erase(), and indices
+// passed to operator[]. Picked for the whole program by defining
+// SERENE_CHECK_LEVEL (see SERENE_CHECK_LEVEL in CMakeLists.txt):
+//   SERENE_CHECK_THROW     - the default: std::out_of_range, except for
+//                            operator[], which is not checked
+//   SERENE_CHECK_HARDENED  - everything is checked, operator[] included,
+//                            and a violation prints a message and aborts.
+//                            Nothing throws, so callers need no unwinding
+//                            code for these calls.
+//   SERENE_CHECK_ASSERT    - everything is checked like by assert(), i.e.
+//                            only when NDEBUG is not defined
+//   SERENE_CHECK_UNCHECKED - nothing is checked, for release hot paths
+// at() throws at every level, that is what it is for. All translation
+// units of a program have to use the same level.
+#define SERENE_CHECK_UNCHECKED 0
+#define SERENE_CHECK_ASSERT 1
+#define SERENE_CHECK_HARDENED 2
+#define SERENE_CHECK_THROW 3
+
+#ifndef SERENE_CHECK_LEVEL
+#define SERENE_CHECK_LEVEL SERENE_CHECK_THROW
+#endif
+
+namespace serene_checks_detail {
+
+// Out of line and cold, so that the checks stay a compare and a jump
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline, cold))
+#endif
+[[noreturn]] inline void fail(const char *message) {
+    std::fprintf(stderr, "serene precondition violated: %s\n", message);
+    std::abort();
+}
+
+} // namespace serene_checks_detail
+
+// A precondition that throws Exception(message) at the default level
+template <typename Exception = std::out_of_range>
+constexpr void serene_check(bool ok, const char *message) {
+#if SERENE_CHECK_LEVEL == SERENE_CHECK_THROW
+    if (!ok) {
+        throw Exception(message);
+    }
+#elif SERENE_CHECK_LEVEL == SERENE_CHECK_HARDENED ||                          \
+    (SERENE_CHECK_LEVEL == SERENE_CHECK_ASSERT && !defined(NDEBUG))
+    if (!ok) [[unlikely]] {
+        serene_checks_detail::fail(message);
+    }
+#else
+    (void)ok;
+    (void)message;
+#endif
+}
+
+// The index passed to operator[], only checked at the hardened and the
+// assert levels
+constexpr void serene_check_index(bool ok) {
+#if SERENE_CHECK_LEVEL != SERENE_CHECK_THROW
+    serene_check(ok, "index out of range");
+#else
+    (void)ok;
+#endif
+}
+
+#endif // INCLUDE_SERENE_CHECKS_HPP_
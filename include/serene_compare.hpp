@@ -0,0 +1,156 @@
+#ifndef INCLUDE_SERENE_COMPARE_HPP_
+#define INCLUDE_SERENE_COMPARE_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SERENE_COMPARE_X86 1
+#endif
+
+// Vectorized == and <=> for VectorTheSerene and ArrayTheSteadfast of integral
+// and byte-like elements, whose equality is the equality of their bytes.
+// Floating point types are excluded (NaN != NaN, -0.0 == 0.0).
+template <typename T>
+inline constexpr bool is_bytewise_comparable_serene =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+    std::is_same_v<T, std::byte>;
+
+namespace serene_compare_detail {
+
+// Each kernel returns the index of the first differing byte, or n
+
+inline size_t mismatch_scalar(const unsigned char *a, const unsigned char *b,
+                              size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        if (x != y) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return i + std::countr_zero(x ^ y) / 8;
+            } else {
+                return i + std::countl_zero(x ^ y) / 8;
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#ifdef SERENE_COMPARE_X86
+__attribute__((target("sse2"))) inline size_t
+mismatch_sse2(const unsigned char *a, const unsigned char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        unsigned equal = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+        if (equal != 0xFFFF) {
+            return i + std::countr_one(equal);
+        }
+    }
+    return i + mismatch_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t
+mismatch_avx2(const unsigned char *a, const unsigned char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i y =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        unsigned equal =
+            unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (equal != 0xFFFFFFFF) {
+            return i + std::countr_one(equal);
+        }
+    }
+    return i + mismatch_sse2(a + i, b + i, n - i);
+}
+#endif
+
+using MismatchKernel = size_t (*)(const unsigned char *, const unsigned char *,
+                                  size_t);
+
+// Picked once, on first use, by the CPU we are running on
+inline MismatchKernel select_mismatch_kernel() {
+#ifdef SERENE_COMPARE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return mismatch_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return mismatch_sse2;
+    }
+#endif
+    return mismatch_scalar;
+}
+
+inline size_t mismatch_bytes(const void *a, const void *b, size_t n) {
+    static const MismatchKernel kernel = select_mismatch_kernel();
+    return kernel(static_cast<const unsigned char *>(a),
+                  static_cast<const unsigned char *>(b), n);
+}
+
+} // namespace serene_compare_detail
+
+// Both fall back to plain loops during constant evaluation
+
+template <typename T>
+constexpr bool serene_equal(const T *a, const T *b, size_t n) {
+    static_assert(is_bytewise_comparable_serene<T>);
+    if (std::is_constant_evaluated()) {
+        return std::equal(a, a + n, b);
+    }
+    // libc's memcmp is already vectorized and dispatched by CPU
+    return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+// Lexicographical comparison of [a, a + a_size) and [b, b + b_size)
+template <typename T>
+constexpr std::strong_ordering serene_compare(const T *a, size_t a_size,
+                                              const T *b, size_t b_size) {
+    static_assert(is_bytewise_comparable_serene<T>);
+    if (std::is_constant_evaluated()) {
+        return std::lexicographical_compare_three_way(a, a + a_size, b,
+                                                      b + b_size);
+    }
+    size_t common = std::min(a_size, b_size);
+    if constexpr (sizeof(T) == 1 && !std::is_signed_v<T>) {
+        // Unsigned bytes order the same way memcmp does
+        if (common != 0) {
+            int result = std::memcmp(a, b, common);
+            if (result != 0) {
+                return result < 0 ? std::strong_ordering::less
+                                  : std::strong_ordering::greater;
+            }
+        }
+        return a_size <=> b_size;
+    } else {
+        size_t byte = serene_compare_detail::mismatch_bytes(
+            a, b, common * sizeof(T));
+        size_t index = byte / sizeof(T);
+        if (index < common) {
+            return a[index] < b[index] ? std::strong_ordering::less
+                                       : std::strong_ordering::greater;
+        }
+        return a_size <=> b_size;
+    }
+}
+
+#endif // INCLUDE_SERENE_COMPARE_HPP_
@@ -0,0 +1,578 @@
+#ifndef INCLUDE_SERENE_SERIALIZE_HPP_
+#define INCLUDE_SERENE_SERIALIZE_HPP_
+
+#include "./array_the_steadfast.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#define SERENE_SERIALIZE_WRITEV 1
+#endif
+
+// Binary format for VectorTheSerene and ArrayTheSteadfast of trivially
+// copyable elements, and for VectorTheSerene<VectorTheSerene<T>>:
+//
+//   header   SereneBlobHeader, 32 bytes
+//   offsets  nested only: count + 1 uint64_t, row i is values
+//            [offsets[i], offsets[i + 1])
+//   padding  zeros up to the alignment of T
+//   values   the raw elements
+//
+// The elements are written as they are in memory, so a blob can be read back
+// as a zero-copy view (serene_view, serene_nested_view) of the buffer or
+// file it is in. Blobs are only readable on machines with the same
+// endianness and the same element size and alignment; everything else is
+// rejected with SereneFormatError.
+
+struct SereneFormatError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct SereneBlobHeader {
+    static constexpr uint32_t expected_magic = 0x454e5253; // "SRNE"
+    static constexpr uint16_t current_version = 1;
+    static constexpr uint8_t little_endian = 1;
+    static constexpr uint8_t big_endian = 2;
+    static constexpr uint8_t flat = 0;
+    static constexpr uint8_t nested = 1;
+
+    uint32_t magic = expected_magic;
+    uint16_t version = current_version;
+    uint8_t endianness =
+        std::endian::native == std::endian::little ? little_endian : big_endian;
+    uint8_t kind = flat;
+    uint32_t element_size = 0;
+    uint32_t alignment = 0;
+    // Elements for flat blobs, rows for nested ones
+    uint64_t count = 0;
+    // serene_checksum of the offsets and the values
+    uint64_t checksum = 0;
+};
+
+static_assert(sizeof(SereneBlobHeader) == 32);
+
+// Fast non-cryptographic 64-bit checksum, fed in pieces: four independent
+// multiply-rotate lanes over 32-byte blocks, so it runs at several bytes
+// per cycle. Only catches corruption, not tampering.
+class SereneChecksum {
+  private:
+    static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+    uint64_t lanes_[4] = {prime1, prime2, ~prime1, ~prime2};
+    unsigned char tail_[32] = {};
+    size_t tail_size_ = 0;
+    uint64_t total_ = 0;
+
+    static uint64_t load(const unsigned char *p) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        return word;
+    }
+
+    void block(const unsigned char *p) {
+        for (int i = 0; i < 4; ++i) {
+            lanes_[i] = std::rotl(lanes_[i] + load(p + 8 * i) * prime2, 31) *
+                        prime1;
+        }
+    }
+
+  public:
+    void update(const void *data, size_t size) {
+        auto p = static_cast<const unsigned char *>(data);
+        total_ += size;
+        if (tail_size_ != 0) {
+            size_t taken = std::min(size, 32 - tail_size_);
+            std::memcpy(tail_ + tail_size_, p, taken);
+            tail_size_ += taken;
+            p += taken;
+            size -= taken;
+            if (tail_size_ < 32) {
+                return;
+            }
+            block(tail_);
+            tail_size_ = 0;
+        }
+        for (; size >= 32; p += 32, size -= 32) {
+            block(p);
+        }
+        if (size != 0) {
+            std::memcpy(tail_, p, size);
+            tail_size_ = size;
+        }
+    }
+
+    uint64_t digest() const {
+        uint64_t hash = std::rotl(lanes_[0], 1) + std::rotl(lanes_[1], 7) +
+                        std::rotl(lanes_[2], 12) + std::rotl(lanes_[3], 18);
+        hash ^= total_ * prime1;
+        for (size_t i = 0; i < tail_size_; ++i) {
+            hash = std::rotl(hash ^ (tail_[i] * prime2), 11) * prime1;
+        }
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        return hash;
+    }
+};
+
+namespace serene_serialize_detail {
+
+template <typename> struct is_vector : std::false_type {};
+template <typename T, typename Allocator, typename GrowthPolicy, size_t N>
+struct is_vector<VectorTheSerene<T, Allocator, GrowthPolicy, N>>
+    : std::true_type {};
+
+template <typename> struct is_array : std::false_type {};
+template <typename T, size_t N>
+struct is_array<ArrayTheSteadfast<T, N>> : std::true_type {};
+
+// A piece of the blob
+struct Piece {
+    const void *data;
+    size_t size;
+};
+
+inline constexpr size_t align_up(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// base + count * unit for a count read from a blob, which may be forged
+inline size_t checked_size(size_t base, uint64_t count, size_t unit) {
+    if (count > (std::numeric_limits<size_t>::max() - base) / unit) {
+        throw SereneFormatError("blob is too large");
+    }
+    return base + size_t(count) * unit;
+}
+
+inline const std::byte *zeros() {
+    alignas(64) static const std::byte buffer[64] = {};
+    return buffer;
+}
+
+inline void add_padding(std::vector<Piece> &pieces, size_t padding) {
+    for (; padding > 0; padding -= std::min<size_t>(padding, 64)) {
+        pieces.push_back({zeros(), std::min<size_t>(padding, 64)});
+    }
+}
+
+} // namespace serene_serialize_detail
+
+template <typename Container>
+concept serene_flat_serializable =
+    (serene_serialize_detail::is_vector<Container>::value ||
+     serene_serialize_detail::is_array<Container>::value) &&
+    std::is_trivially_copyable_v<typename Container::value_type>;
+
+template <typename Container>
+concept serene_nested_serializable =
+    serene_serialize_detail::is_vector<Container>::value &&
+    serene_flat_serializable<typename Container::value_type> &&
+    serene_serialize_detail::is_vector<typename Container::value_type>::value;
+
+template <typename Container>
+concept serene_serializable = serene_flat_serializable<Container> ||
+                              serene_nested_serializable<Container>;
+
+namespace serene_serialize_detail {
+
+// What the blob stores: the elements, or the elements of the rows
+template <typename Container> struct element_of {
+    using type = typename Container::value_type;
+};
+template <serene_nested_serializable Container>
+struct element_of<Container> {
+    using type = typename Container::value_type::value_type;
+};
+
+// A blob as a list of pieces pointing into the container, nothing copied
+// but the header and the offsets
+class Encoded {
+  private:
+    SereneBlobHeader header_;
+    std::vector<uint64_t> offsets_;
+    std::vector<Piece> pieces_;
+
+    template <typename T> void start(uint8_t kind, size_t count) {
+        header_.kind = kind;
+        header_.element_size = sizeof(T);
+        header_.alignment = alignof(T);
+        header_.count = count;
+        pieces_.push_back({&header_, sizeof(header_)});
+    }
+
+  public:
+    Encoded() = default;
+    // The pieces point to the members
+    Encoded(const Encoded &) = delete;
+    Encoded &operator=(const Encoded &) = delete;
+
+    template <serene_flat_serializable Container>
+    explicit Encoded(const Container &container) {
+        using T = typename Container::value_type;
+        start<T>(SereneBlobHeader::flat, container.size());
+        add_padding(pieces_, align_up(sizeof(header_), alignof(T)) -
+                                 sizeof(header_));
+        SereneChecksum checksum;
+        size_t bytes = container.size() * sizeof(T);
+        if (bytes != 0) {
+            pieces_.push_back({&*container.begin(), bytes});
+            checksum.update(&*container.begin(), bytes);
+        }
+        header_.checksum = checksum.digest();
+    }
+
+    template <serene_nested_serializable Container>
+    explicit Encoded(const Container &container) {
+        using T = typename Container::value_type::value_type;
+        start<T>(SereneBlobHeader::nested, container.size());
+        offsets_.reserve(container.size() + 1);
+        offsets_.push_back(0);
+        for (const auto &row : container) {
+            offsets_.push_back(offsets_.back() + row.size());
+        }
+        pieces_.push_back({offsets_.data(), offsets_.size() * 8});
+        size_t end_of_offsets = sizeof(header_) + offsets_.size() * 8;
+        add_padding(pieces_,
+                    align_up(end_of_offsets, alignof(T)) - end_of_offsets);
+        SereneChecksum checksum;
+        checksum.update(offsets_.data(), offsets_.size() * 8);
+        for (const auto &row : container) {
+            if (row.size() != 0) {
+                pieces_.push_back({&*row.begin(), row.size() * sizeof(T)});
+                checksum.update(&*row.begin(), row.size() * sizeof(T));
+            }
+        }
+        header_.checksum = checksum.digest();
+    }
+
+    const std::vector<Piece> &pieces() const { return pieces_; }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto &piece : pieces_) {
+            total += piece.size;
+        }
+        return total;
+    }
+};
+
+// Where the parts of a validated blob are
+struct Decoded {
+    const uint64_t *offsets = nullptr;
+    const std::byte *values = nullptr;
+    size_t count = 0;
+    size_t value_count = 0;
+};
+
+template <typename T>
+void check_header(const SereneBlobHeader &header, uint8_t kind) {
+    if (header.magic != SereneBlobHeader::expected_magic) {
+        throw SereneFormatError("not a serialized container");
+    }
+    if (header.version == 0 ||
+        header.version > SereneBlobHeader::current_version) {
+        throw SereneFormatError("unsupported format version");
+    }
+    if (header.endianness != SereneBlobHeader().endianness) {
+        throw SereneFormatError("blob has a different endianness");
+    }
+    if (header.kind != kind) {
+        throw SereneFormatError(kind == SereneBlobHeader::flat
+                                    ? "blob holds a nested container"
+                                    : "blob holds a flat container");
+    }
+    if (header.element_size != sizeof(T) || header.alignment != alignof(T)) {
+        throw SereneFormatError("element size or alignment differs");
+    }
+}
+
+template <typename T>
+Decoded decode(const void *data, size_t size, uint8_t kind, bool verify) {
+    auto bytes = static_cast<const std::byte *>(data);
+    SereneBlobHeader header;
+    if (size < sizeof(header)) {
+        throw SereneFormatError("blob is too short");
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    check_header<T>(header, kind);
+
+    Decoded decoded;
+    decoded.count = header.count;
+    size_t offset = sizeof(header);
+    SereneChecksum checksum;
+    if (kind == SereneBlobHeader::nested) {
+        if (header.count >= (size - offset) / 8) {
+            throw SereneFormatError("blob is truncated");
+        }
+        size_t offsets_size = (header.count + 1) * 8;
+        if (reinterpret_cast<uintptr_t>(bytes + offset) % 8 != 0) {
+            throw SereneFormatError("blob is misaligned");
+        }
+        decoded.offsets = reinterpret_cast<const uint64_t *>(bytes + offset);
+        if (verify) {
+            checksum.update(decoded.offsets, offsets_size);
+        }
+        for (size_t i = 0; i < header.count; ++i) {
+            if (decoded.offsets[i] > decoded.offsets[i + 1]) {
+                throw SereneFormatError("row offsets are not sorted");
+            }
+        }
+        if (decoded.offsets[0] != 0) {
+            throw SereneFormatError("row offsets do not start at 0");
+        }
+        decoded.value_count = decoded.offsets[header.count];
+        offset += offsets_size;
+    } else {
+        decoded.value_count = header.count;
+    }
+    offset = align_up(offset, alignof(T));
+    if (offset > size ||
+        decoded.value_count > (size - offset) / sizeof(T)) {
+        throw SereneFormatError("blob is truncated");
+    }
+    decoded.values = bytes + offset;
+    if (verify) {
+        checksum.update(decoded.values, decoded.value_count * sizeof(T));
+        if (checksum.digest() != header.checksum) {
+            throw SereneFormatError("checksum mismatch");
+        }
+    }
+    return decoded;
+}
+
+template <typename Container>
+void copy_row(Container &row, const std::byte *values, size_t count) {
+    using T = typename Container::value_type;
+    if constexpr (is_array<Container>::value) {
+        if (count != row.size()) {
+            throw SereneFormatError("array size differs");
+        }
+    } else {
+        row.resize_uninitialized(count);
+    }
+    if (count != 0) {
+        std::memcpy(static_cast<void *>(&*row.begin()), values,
+                    count * sizeof(T));
+    }
+}
+
+} // namespace serene_serialize_detail
+
+// Size of the blob of container in bytes
+template <serene_serializable Container>
+size_t serene_serialized_size(const Container &container) {
+    return serene_serialize_detail::Encoded(container).size();
+}
+
+// The blob of container as bytes, e.g. to send it over the network
+template <serene_serializable Container>
+VectorTheSerene<std::byte> serene_serialize(const Container &container) {
+    serene_serialize_detail::Encoded encoded(container);
+    VectorTheSerene<std::byte> blob;
+    blob.resize_uninitialized(encoded.size());
+    std::byte *out = blob.begin();
+    for (const auto &piece : encoded.pieces()) {
+        std::memcpy(out, piece.data, piece.size);
+        out += piece.size;
+    }
+    return blob;
+}
+
+template <serene_serializable Container>
+void serene_serialize(std::ostream &os, const Container &container) {
+    serene_serialize_detail::Encoded encoded(container);
+    for (const auto &piece : encoded.pieces()) {
+        os.write(static_cast<const char *>(piece.data),
+                 std::streamsize(piece.size));
+    }
+}
+
+#ifdef SERENE_SERIALIZE_WRITEV
+// Writes the blob of container to a file descriptor straight from the
+// container's memory: a single writev for flat containers, one per IOV_MAX
+// rows for nested ones. Throws std::system_error if writing fails.
+template <serene_serializable Container>
+void serene_serialize(int fd, const Container &container) {
+    serene_serialize_detail::Encoded encoded(container);
+    std::vector<iovec> pending;
+    pending.reserve(encoded.pieces().size());
+    for (const auto &piece : encoded.pieces()) {
+        pending.push_back({const_cast<void *>(piece.data), piece.size});
+    }
+    size_t first = 0;
+    while (first < pending.size()) {
+        int batch = int(std::min<size_t>(pending.size() - first, IOV_MAX));
+        ssize_t written = writev(fd, &pending[first], batch);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        // Skip what went out, possibly stopping in the middle of a piece
+        size_t left = size_t(written);
+        while (first < pending.size() && left >= pending[first].iov_len) {
+            left -= pending[first].iov_len;
+            ++first;
+        }
+        if (left != 0) {
+            pending[first].iov_base =
+                static_cast<char *>(pending[first].iov_base) + left;
+            pending[first].iov_len -= left;
+        }
+    }
+}
+#endif
+
+// Copies a blob back into a container. verify checks the checksum.
+template <serene_serializable Container>
+Container serene_deserialize(const void *data, size_t size,
+                             bool verify = true) {
+    using namespace serene_serialize_detail;
+    Container container{};
+    if constexpr (serene_flat_serializable<Container>) {
+        using T = typename Container::value_type;
+        auto decoded = decode<T>(data, size, SereneBlobHeader::flat, verify);
+        copy_row(container, decoded.values, decoded.count);
+    } else {
+        using T = typename Container::value_type::value_type;
+        auto decoded =
+            decode<T>(data, size, SereneBlobHeader::nested, verify);
+        container.reserve(decoded.count);
+        for (size_t i = 0; i < decoded.count; ++i) {
+            copy_row(container.emplace_back(),
+                     decoded.values + decoded.offsets[i] * sizeof(T),
+                     decoded.offsets[i + 1] - decoded.offsets[i]);
+        }
+    }
+    return container;
+}
+
+// Reads one blob from is. Throws SereneFormatError if it is cut short.
+template <serene_serializable Container>
+Container serene_deserialize(std::istream &is, bool verify = true) {
+    using namespace serene_serialize_detail;
+    using T = typename element_of<Container>::type;
+    constexpr uint8_t kind = serene_flat_serializable<Container>
+                                 ? SereneBlobHeader::flat
+                                 : SereneBlobHeader::nested;
+    SereneBlobHeader header;
+    if (!is.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        throw SereneFormatError("blob is too short");
+    }
+    // Before trusting any size in it
+    check_header<T>(header, kind);
+
+    // Read into 8-byte words, so that the values are aligned in memory.
+    // A chunk at a time: a forged size makes the read fail at the end of
+    // the stream, instead of allocating all of it up front.
+    VectorTheSerene<uint64_t> blob;
+    auto read = [&](size_t from, size_t to) {
+        constexpr size_t chunk = size_t(1) << 20;
+        while (from < to) {
+            size_t step = std::min(to - from, chunk);
+            blob.resize_uninitialized((from + step + 7) / 8);
+            auto bytes = reinterpret_cast<char *>(blob.begin());
+            if (!is.read(bytes + from, std::streamsize(step))) {
+                throw SereneFormatError("blob is truncated");
+            }
+            from += step;
+        }
+    };
+    size_t size = sizeof(header);
+    uint64_t value_count = header.count;
+    if constexpr (kind == SereneBlobHeader::nested) {
+        // The offsets first, they tell the size of the rest. The extra 8
+        // are for the last offset, the alignof(T) for the padding after it.
+        size_t offsets_end =
+            checked_size(size + 8 + alignof(T), header.count, 8) - alignof(T);
+        read(size, offsets_end);
+        size = offsets_end;
+        value_count = blob[size / 8 - 1];
+    }
+    size_t values_offset = align_up(size, alignof(T));
+    size_t values_end = checked_size(values_offset, value_count, sizeof(T));
+    read(size, values_end);
+    size = values_end;
+    std::memcpy(blob.begin(), &header, sizeof(header));
+    return serene_deserialize<Container>(blob.begin(), size, verify);
+}
+
+// The elements of a flat blob, read in place. The buffer has to stay alive
+// and be aligned for T (e.g. a mapped file, or serene_serialize's result).
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+std::span<const T> serene_view(const void *data, size_t size,
+                               bool verify = true) {
+    auto decoded = serene_serialize_detail::decode<T>(
+        data, size, SereneBlobHeader::flat, verify);
+    if (reinterpret_cast<uintptr_t>(decoded.values) % alignof(T) != 0) {
+        throw SereneFormatError("blob is misaligned");
+    }
+    return {reinterpret_cast<const T *>(decoded.values), decoded.count};
+}
+
+// The rows of a nested blob, read in place
+template <typename T> class NestedViewTheSerene {
+  private:
+    const uint64_t *offsets_ = nullptr;
+    const T *values_ = nullptr;
+    size_t size_ = 0;
+
+  public:
+    NestedViewTheSerene() = default;
+    NestedViewTheSerene(const uint64_t *offsets, const T *values, size_t size)
+        : offsets_(offsets), values_(values), size_(size) {}
+
+    std::span<const T> operator[](size_t row) const {
+        return {values_ + offsets_[row], values_ + offsets_[row + 1]};
+    }
+
+    std::span<const T> at(size_t row) const {
+        if (row >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return (*this)[row];
+    }
+
+    // All the rows one after another
+    std::span<const T> values() const {
+        return {values_, size_ == 0 ? 0 : offsets_[size_]};
+    }
+
+    size_t size() const { return size_; }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+};
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+NestedViewTheSerene<T> serene_nested_view(const void *data, size_t size,
+                                          bool verify = true) {
+    auto decoded = serene_serialize_detail::decode<T>(
+        data, size, SereneBlobHeader::nested, verify);
+    if (reinterpret_cast<uintptr_t>(decoded.values) % alignof(T) != 0) {
+        throw SereneFormatError("blob is misaligned");
+    }
+    return {decoded.offsets, reinterpret_cast<const T *>(decoded.values),
+            decoded.count};
+}
+
+#endif // INCLUDE_SERENE_SERIALIZE_HPP_
@@ -0,0 +1,211 @@
+#ifndef INCLUDE_SERENE_STATS_HPP_
+#define INCLUDE_SERENE_STATS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+// Opt-in statistics for VectorTheSerene, per vector type. Define
+// VECTOR_THE_SERENE_STATS (set(ENABLE_VECTOR_STATS ON) in CMakeLists.txt) to
+// enable them; otherwise every hook compiles to nothing. When enabled, the
+// stats of every vector type that was used are printed to stderr at exit.
+#ifdef VECTOR_THE_SERENE_STATS
+inline constexpr bool serene_stats_enabled = true;
+#else
+inline constexpr bool serene_stats_enabled = false;
+#endif
+
+// elements_moved and elements_copied count every element built from
+// another value: by push_back, emplace_back, insert and the range members,
+// and by growing and shifting the buffer
+struct SereneStatsSnapshot {
+    std::string type_name;
+    size_t allocations = 0;
+    size_t bytes_allocated = 0;
+    size_t reallocations = 0;
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t peak_capacity = 0;
+};
+
+struct SereneStats {
+    std::string type_name;
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes_allocated{0};
+    std::atomic<size_t> reallocations{0};
+    std::atomic<size_t> elements_moved{0};
+    std::atomic<size_t> elements_copied{0};
+    std::atomic<size_t> peak_capacity{0};
+
+    explicit SereneStats(std::string name) : type_name(std::move(name)) {}
+
+    SereneStatsSnapshot snapshot() const {
+        return {type_name,
+                allocations.load(std::memory_order_relaxed),
+                bytes_allocated.load(std::memory_order_relaxed),
+                reallocations.load(std::memory_order_relaxed),
+                elements_moved.load(std::memory_order_relaxed),
+                elements_copied.load(std::memory_order_relaxed),
+                peak_capacity.load(std::memory_order_relaxed)};
+    }
+
+    void reset() {
+        allocations = 0;
+        bytes_allocated = 0;
+        reallocations = 0;
+        elements_moved = 0;
+        elements_copied = 0;
+        peak_capacity = 0;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &os,
+                                const SereneStatsSnapshot &stats) {
+    return os << stats.type_name << ": allocations=" << stats.allocations
+              << " bytes_allocated=" << stats.bytes_allocated
+              << " reallocations=" << stats.reallocations
+              << " elements_moved=" << stats.elements_moved
+              << " elements_copied=" << stats.elements_copied
+              << " peak_capacity=" << stats.peak_capacity;
+}
+
+// All the stats ever created. Never destroyed, so that vectors with static
+// storage duration can still report while the program shuts down.
+class SereneStatsRegistry {
+  private:
+    std::mutex mutex_;
+    std::deque<SereneStats> stats_;
+
+    static std::string demangle(const char *name) {
+#if defined(__GNUG__)
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+            std::string result(demangled);
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+  public:
+    static SereneStatsRegistry &instance() {
+        static auto *registry = [] {
+            auto *created = new SereneStatsRegistry();
+            std::atexit([] { instance().dump(std::cerr); });
+            return created;
+        }();
+        return *registry;
+    }
+
+    SereneStats &add(const std::type_info &type) {
+        std::lock_guard lock(mutex_);
+        return stats_.emplace_back(demangle(type.name()));
+    }
+
+    void dump(std::ostream &os) {
+        std::lock_guard lock(mutex_);
+        for (const auto &stats : stats_) {
+            os << stats.snapshot() << '\n';
+        }
+    }
+};
+
+// The stats of one vector type, registered on first use
+template <typename Vector> SereneStats &serene_stats_for() {
+    static SereneStats &stats =
+        SereneStatsRegistry::instance().add(typeid(Vector));
+    return stats;
+}
+
+// The hooks VectorTheSerene calls, no-ops unless the stats are enabled, and
+// during constant evaluation
+template <typename Vector> struct SereneStatsHooks {
+    static constexpr void allocated(size_t bytes) {
+        if constexpr (serene_stats_enabled) {
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+            auto &stats = serene_stats_for<Vector>();
+            stats.allocations.fetch_add(1, std::memory_order_relaxed);
+            stats.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr void reallocated() {
+        if constexpr (serene_stats_enabled) {
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+            serene_stats_for<Vector>().reallocations.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr void moved(size_t count) {
+        if constexpr (serene_stats_enabled) {
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+            serene_stats_for<Vector>().elements_moved.fetch_add(
+                count, std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr void copied(size_t count) {
+        if constexpr (serene_stats_enabled) {
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+            serene_stats_for<Vector>().elements_copied.fetch_add(
+                count, std::memory_order_relaxed);
+        }
+    }
+
+    // An element built from a single argument is a copy of an lvalue and
+    // a move of an rvalue, same as the items of a range; other elements are
+    // new values built in place
+    template <typename... Args> static constexpr void constructed() {
+        if constexpr (sizeof...(Args) == 1) {
+            if constexpr ((std::is_lvalue_reference_v<Args> && ...)) {
+                copied(1);
+            } else {
+                moved(1);
+            }
+        }
+    }
+
+    static constexpr void capacity_changed(size_t capacity) {
+        if constexpr (serene_stats_enabled) {
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+            auto &peak = serene_stats_for<Vector>().peak_capacity;
+            size_t current = peak.load(std::memory_order_relaxed);
+            while (capacity > current &&
+                   !peak.compare_exchange_weak(current, capacity,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+    }
+};
+
+// Prints the stats of every vector type used so far
+inline void dump_serene_stats(std::ostream &os = std::cerr) {
+    if constexpr (serene_stats_enabled) {
+        SereneStatsRegistry::instance().dump(os);
+    }
+}
+
+#endif // INCLUDE_SERENE_STATS_HPP_
@@ -0,0 +1,434 @@
+#ifndef INCLUDE_SOA_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_SOA_VECTOR_THE_SERENE_HPP_
+
+#include "./growth_policies.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Structure of arrays: a vector of records with fields Fields..., where every
+// field has its own column, so a loop over one or two fields streams only
+// those through the cache instead of whole records. All the columns live in
+// one allocation, each starting on a cache line (column_alignment), and grow
+// together with one growth decision.
+//
+// Rows are accessed as tuples of references, which work with structured
+// bindings:
+//   SoaVectorTheSerene<int, double> v;
+//   v.push_back(1, 2.0);
+//   auto [id, price] = v[0];
+//   for (double &p : v.column<1>()) ...
+template <typename... Fields> class SoaVectorTheSerene {
+  public:
+    static_assert(sizeof...(Fields) > 0, "At least one field is needed");
+    static_assert((std::is_nothrow_move_constructible_v<Fields> && ...),
+                  "Fields have to be nothrow move constructible");
+
+    static constexpr size_t column_count = sizeof...(Fields);
+    static constexpr size_t column_alignment =
+        std::max({size_t(64), alignof(Fields)...});
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields &...>;
+    using const_reference = std::tuple<const Fields &...>;
+
+  private:
+    using growth = DoublingGrowth<>;
+    using indices = std::make_index_sequence<column_count>;
+    using Columns = std::array<void *, column_count>;
+
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    // nullptr while capacity_ == 0, so empty vectors never allocate
+    std::byte *buffer_ = nullptr;
+    Columns columns_{};
+
+    static constexpr size_t align_up(size_t n) {
+        return (n + column_alignment - 1) / column_alignment *
+               column_alignment;
+    }
+
+    // Where each column starts for a given capacity, and the total size
+    static std::array<size_t, column_count + 1> layout(size_t capacity) {
+        constexpr size_t sizes[] = {sizeof(Fields)...};
+        std::array<size_t, column_count + 1> offsets{};
+        for (size_t i = 0; i < column_count; ++i) {
+            offsets[i + 1] = align_up(offsets[i] + capacity * sizes[i]);
+        }
+        return offsets;
+    }
+
+    static std::byte *allocate(size_t capacity, Columns &columns) {
+        auto offsets = layout(capacity);
+        auto buffer = static_cast<std::byte *>(::operator new(
+            offsets.back(), std::align_val_t(column_alignment)));
+        for (size_t i = 0; i < column_count; ++i) {
+            columns[i] = buffer + offsets[i];
+        }
+        return buffer;
+    }
+
+    static void deallocate(std::byte *buffer) {
+        if (buffer != nullptr) {
+            ::operator delete(buffer, std::align_val_t(column_alignment));
+        }
+    }
+
+    template <size_t I>
+    static field_type<I> *column_of(const Columns &columns) {
+        return static_cast<field_type<I> *>(columns[I]);
+    }
+
+    template <size_t I> field_type<I> *column_data() const {
+        return column_of<I>(columns_);
+    }
+
+    // Constructs row from one argument per field, destroying the fields
+    // already constructed if one of them throws
+    template <typename... Args, size_t... I>
+    static void construct_row(const Columns &columns, size_t row,
+                              std::index_sequence<I...>, Args &&...args) {
+        size_t constructed = 0;
+        try {
+            ((::new (static_cast<void *>(column_of<I>(columns) + row))
+                  field_type<I>(std::forward<Args>(args)),
+              ++constructed),
+             ...);
+        } catch (...) {
+            (
+                [&] {
+                    if (I < constructed) {
+                        std::destroy_at(column_of<I>(columns) + row);
+                    }
+                }(),
+                ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void destroy_rows(size_t first, size_t last, std::index_sequence<I...>) {
+        (std::destroy(column_data<I>() + first, column_data<I>() + last),
+         ...);
+    }
+
+    // Moves column I into dest, one memcpy for trivially relocatable fields
+    template <size_t I> void relocate_column(field_type<I> *dest) {
+        using F = field_type<I>;
+        F *source = column_data<I>();
+        if constexpr (is_trivially_relocatable_serene_v<F>) {
+            if (size_ != 0) {
+                std::memcpy(static_cast<void *>(dest), source,
+                            size_ * sizeof(F));
+            }
+        } else {
+            for (size_t row = 0; row < size_; ++row) {
+                ::new (static_cast<void *>(dest + row))
+                    F(std::move(source[row]));
+                std::destroy_at(source + row);
+            }
+        }
+    }
+
+    // Moves everything to a buffer of new_capacity rows. Can't throw after
+    // the allocation, as moves of the fields can't.
+    void reallocate(size_t new_capacity, Columns &new_columns,
+                    std::byte *new_buffer) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (relocate_column<I>(column_of<I>(new_columns)), ...);
+        }(indices{});
+        deallocate(buffer_);
+        buffer_ = new_buffer;
+        columns_ = new_columns;
+        capacity_ = new_capacity;
+    }
+
+    template <size_t... I>
+    reference row(size_t index, std::index_sequence<I...>) const {
+        return reference(column_data<I>()[index]...);
+    }
+
+  public:
+    template <bool Const> class RowIterator {
+      private:
+        using owner = std::conditional_t<Const, const SoaVectorTheSerene,
+                                         SoaVectorTheSerene>;
+
+        owner *vector_ = nullptr;
+        size_t index_ = 0;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = SoaVectorTheSerene::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        RowIterator() = default;
+        RowIterator(owner *vector, size_t index)
+            : vector_(vector), index_(index) {}
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        RowIterator(const RowIterator<OtherConst> &other)
+            : vector_(other.vector_), index_(other.index_) {}
+
+        auto operator*() const { return (*vector_)[index_]; }
+        auto operator[](difference_type n) const {
+            return (*vector_)[index_ + n];
+        }
+
+        RowIterator &operator++() {
+            ++index_;
+            return *this;
+        }
+        RowIterator operator++(int) {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+        RowIterator &operator--() {
+            --index_;
+            return *this;
+        }
+        RowIterator operator--(int) {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+        RowIterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        RowIterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        friend RowIterator operator+(RowIterator it, difference_type n) {
+            return it += n;
+        }
+        friend RowIterator operator+(difference_type n, RowIterator it) {
+            return it += n;
+        }
+        friend RowIterator operator-(RowIterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const RowIterator &a,
+                                         const RowIterator &b) {
+            return difference_type(a.index_) - difference_type(b.index_);
+        }
+
+        bool operator==(const RowIterator &other) const {
+            return index_ == other.index_;
+        }
+        auto operator<=>(const RowIterator &other) const {
+            return index_ <=> other.index_;
+        }
+
+        template <bool> friend class RowIterator;
+    };
+
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    SoaVectorTheSerene() = default;
+
+    // The destructor won't run if a copy throws, so the rows built so far
+    // and the buffer are freed here
+    SoaVectorTheSerene(const SoaVectorTheSerene &other) {
+        try {
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; ++i) {
+                std::apply(
+                    [this](const auto &...fields) { emplace_back(fields...); },
+                    other[i]);
+            }
+        } catch (...) {
+            clear();
+            deallocate(buffer_);
+            throw;
+        }
+    }
+
+    SoaVectorTheSerene(SoaVectorTheSerene &&other) noexcept
+        : size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          buffer_(std::exchange(other.buffer_, nullptr)),
+          columns_(std::exchange(other.columns_, Columns{})) {}
+
+    SoaVectorTheSerene &operator=(const SoaVectorTheSerene &other) {
+        if (this != &other) {
+            SoaVectorTheSerene copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SoaVectorTheSerene &operator=(SoaVectorTheSerene &&other) noexcept {
+        if (this != &other) {
+            SoaVectorTheSerene moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~SoaVectorTheSerene() {
+        clear();
+        deallocate(buffer_);
+    }
+
+    void swap(SoaVectorTheSerene &other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(buffer_, other.buffer_);
+        std::swap(columns_, other.columns_);
+    }
+
+    reference operator[](size_t index) { return row(index, indices{}); }
+    const_reference operator[](size_t index) const {
+        return row(index, indices{});
+    }
+
+    reference at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return (*this)[index];
+    }
+    const_reference at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return (*this)[index];
+    }
+
+    // One field of one row, without building the whole tuple
+    template <size_t I> field_type<I> &get(size_t index) {
+        return column_data<I>()[index];
+    }
+    template <size_t I> const field_type<I> &get(size_t index) const {
+        return column_data<I>()[index];
+    }
+
+    // Field I of every row, aligned to column_alignment. Stays valid until
+    // the vector reallocates.
+    template <size_t I> std::span<field_type<I>> column() {
+        return {data<I>(), size_};
+    }
+    template <size_t I> std::span<const field_type<I>> column() const {
+        return {data<I>(), size_};
+    }
+
+    template <size_t I> field_type<I> *data() {
+        return std::assume_aligned<column_alignment>(column_data<I>());
+    }
+    template <size_t I> const field_type<I> *data() const {
+        return std::assume_aligned<column_alignment>(column_data<I>());
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size_}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Columns new_columns;
+            std::byte *new_buffer = allocate(new_capacity, new_columns);
+            reallocate(new_capacity, new_columns, new_buffer);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (size_ == capacity_) {
+            return;
+        }
+        if (size_ == 0) {
+            deallocate(buffer_);
+            buffer_ = nullptr;
+            columns_ = Columns{};
+            capacity_ = 0;
+            return;
+        }
+        Columns new_columns;
+        std::byte *new_buffer = allocate(size_, new_columns);
+        reallocate(size_, new_columns, new_buffer);
+    }
+
+    void clear() {
+        destroy_rows(0, size_, indices{});
+        size_ = 0;
+    }
+
+    // Appends a row from one value per field. When the buffer grows, the row
+    // is constructed before anything is moved, so it may come from the
+    // vector itself.
+    template <typename... Args>
+        requires(sizeof...(Args) == column_count)
+    reference emplace_back(Args &&...args) {
+        if (size_ < capacity_) {
+            construct_row(columns_, size_, indices{},
+                          std::forward<Args>(args)...);
+        } else {
+            size_t new_capacity = growth::next_capacity(
+                capacity_, size_ + 1, (sizeof(Fields) + ...));
+            Columns new_columns;
+            std::byte *new_buffer = allocate(new_capacity, new_columns);
+            try {
+                construct_row(new_columns, size_, indices{},
+                              std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_buffer);
+                throw;
+            }
+            reallocate(new_capacity, new_columns, new_buffer);
+        }
+        return (*this)[size_++];
+    }
+
+    void push_back(const Fields &...fields) { emplace_back(fields...); }
+
+    void push_back(const value_type &record) {
+        std::apply([this](const auto &...fields) { emplace_back(fields...); },
+                   record);
+    }
+
+    void pop_back() {
+        if (size_ > 0) {
+            destroy_rows(size_ - 1, size_, indices{});
+            size_--;
+        }
+    }
+
+    // New rows are value-initialized
+    void resize(size_t new_size) {
+        if (new_size < size_) {
+            destroy_rows(new_size, size_, indices{});
+            size_ = new_size;
+            return;
+        }
+        reserve(new_size);
+        while (size_ < new_size) {
+            emplace_back(Fields()...);
+        }
+    }
+};
+
+#endif // INCLUDE_SOA_VECTOR_THE_SERENE_HPP_
@@ -0,0 +1,348 @@
+#ifndef INCLUDE_STATIC_VECTOR_THE_SERENE_HPP_
+#define INCLUDE_STATIC_VECTOR_THE_SERENE_HPP_
+
+#include "./serene_checks.hpp"
+#include "./serene_compare.hpp"
+#include "./vector_the_serene.hpp"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// A vector of at most N elements stored inside the object, which never
+// touches the heap: it can live on the stack, in shared memory, or in a
+// real-time path that must not allocate. Unlike ArrayTheSteadfast, only the
+// first size() elements are constructed; unlike SmallVectorTheSerene, going
+// past N is an error (std::length_error) instead of a heap allocation, and
+// try_emplace_back reports it without throwing.
+//
+// For trivially copyable T the whole object is trivially copyable, so it
+// can be copied with memcpy or written to a file as it is.
+template <typename T, size_t N> class StaticVectorTheSerene {
+  private:
+    size_t size_ = 0;
+    // A union leaves the elements unconstructed
+    union {
+        T items_[N];
+    };
+
+    void check_not_full() const {
+        if (size_ == N) {
+            throw std::length_error("static vector is full");
+        }
+    }
+
+    void check_not_empty() const {
+        serene_check(size_ != 0, "vector is empty");
+    }
+
+    void destroy_from(size_t first) {
+        std::destroy(items_ + first, items_ + size_);
+        size_ = first;
+    }
+
+    template <typename Iterator> void append(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+  public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<T *>;
+    using const_reverse_iterator = std::reverse_iterator<const T *>;
+
+    StaticVectorTheSerene() {}
+
+    explicit StaticVectorTheSerene(size_t n) { resize(n); }
+    StaticVectorTheSerene(size_t n, const T &value) { resize(n, value); }
+
+    template <std::input_iterator Iterator>
+    StaticVectorTheSerene(Iterator first, Iterator last) {
+        try {
+            append(first, last);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    StaticVectorTheSerene(std::initializer_list<T> list)
+        : StaticVectorTheSerene(list.begin(), list.end()) {}
+
+    // Trivial for trivially copyable T: the bytes of the unused slots are
+    // copied too, which costs nothing extra for small N
+    StaticVectorTheSerene(const StaticVectorTheSerene &other)
+        requires std::is_trivially_copy_constructible_v<T>
+    = default;
+    StaticVectorTheSerene(const StaticVectorTheSerene &other)
+        : StaticVectorTheSerene(other.begin(), other.end()) {}
+
+    // The elements of other are moved from, but stay in other
+    StaticVectorTheSerene(StaticVectorTheSerene &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        requires std::is_trivially_move_constructible_v<T>
+    = default;
+    StaticVectorTheSerene(StaticVectorTheSerene &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        : StaticVectorTheSerene(std::make_move_iterator(other.begin()),
+                                std::make_move_iterator(other.end())) {}
+
+    StaticVectorTheSerene &operator=(const StaticVectorTheSerene &other)
+        requires std::is_trivially_copy_assignable_v<T> &&
+                 std::is_trivially_destructible_v<T>
+    = default;
+    StaticVectorTheSerene &operator=(const StaticVectorTheSerene &other) {
+        if (this != &other) {
+            clear();
+            append(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    StaticVectorTheSerene &operator=(StaticVectorTheSerene &&other)
+        requires std::is_trivially_move_assignable_v<T> &&
+                 std::is_trivially_destructible_v<T>
+    = default;
+    StaticVectorTheSerene &operator=(StaticVectorTheSerene &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            append(std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()));
+        }
+        return *this;
+    }
+
+    ~StaticVectorTheSerene()
+        requires std::is_trivially_destructible_v<T>
+    = default;
+    ~StaticVectorTheSerene() { clear(); }
+
+    T &operator[](size_t index) {
+        serene_check_index(index < size_);
+        return items_[index];
+    }
+    const T &operator[](size_t index) const {
+        serene_check_index(index < size_);
+        return items_[index];
+    }
+
+    T &at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return items_[index];
+    }
+    const T &at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return items_[index];
+    }
+
+    T &front() {
+        check_not_empty();
+        return items_[0];
+    }
+    const T &front() const {
+        check_not_empty();
+        return items_[0];
+    }
+    T &back() {
+        check_not_empty();
+        return items_[size_ - 1];
+    }
+    const T &back() const {
+        check_not_empty();
+        return items_[size_ - 1];
+    }
+
+    T *data() { return items_; }
+    const T *data() const { return items_; }
+
+    iterator begin() { return items_; }
+    iterator end() { return items_ + size_; }
+    const_iterator begin() const { return items_; }
+    const_iterator end() const { return items_ + size_; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    size_t size() const { return size_; }
+    static constexpr size_t capacity() { return N; }
+    static constexpr size_t max_size() { return N; }
+    bool is_empty() const { return size_ == 0; }
+    bool empty() const { return size_ == 0; }
+    bool is_full() const { return size_ == N; }
+
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        check_not_full();
+        return *try_emplace_back(std::forward<Args>(args)...);
+    }
+
+    // nullptr instead of an exception when the vector is full
+    template <typename... Args> T *try_emplace_back(Args &&...args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        T *where =
+            std::construct_at(items_ + size_, std::forward<Args>(args)...);
+        size_++;
+        return where;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        check_not_empty();
+        std::destroy_at(items_ + --size_);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args) {
+        size_t index = pos - items_;
+        serene_check(index <= size_, "index out of range");
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(items_ + index, items_ + size_ - 1, items_ + size_);
+        return items_ + index;
+    }
+
+    iterator insert(const_iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T &&value) {
+        return emplace(pos, std::move(value));
+    }
+
+    // Throws std::length_error before inserting anything if the items
+    // don't fit
+    template <std::forward_iterator Iterator>
+    iterator insert(const_iterator pos, Iterator first, Iterator last) {
+        size_t index = pos - items_;
+        serene_check(index <= size_, "index out of range");
+        if (size_t(std::distance(first, last)) > N - size_) {
+            throw std::length_error("static vector is full");
+        }
+        size_t old_size = size_;
+        append(first, last);
+        std::rotate(items_ + index, items_ + old_size, items_ + size_);
+        return items_ + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> list) {
+        return insert(pos, list.begin(), list.end());
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t index = pos - items_;
+        serene_check(index < size_, "index out of range");
+        std::move(items_ + index + 1, items_ + size_, items_ + index);
+        pop_back();
+        return items_ + index;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t begin_index = first - items_;
+        size_t end_index = last - items_;
+        serene_check(begin_index <= end_index && end_index <= size_,
+                     "index out of range");
+        if (begin_index == end_index) {
+            // Moving the tail onto itself would empty strings and the like
+            return items_ + begin_index;
+        }
+        std::move(items_ + end_index, items_ + size_, items_ + begin_index);
+        destroy_from(size_ - (end_index - begin_index));
+        return items_ + begin_index;
+    }
+
+    void resize(size_t new_size) {
+        if (new_size > N) {
+            throw std::length_error("static vector is full");
+        }
+        if (new_size < size_) {
+            destroy_from(new_size);
+        }
+        while (size_ < new_size) {
+            emplace_back();
+        }
+    }
+
+    void resize(size_t new_size, const T &value) {
+        if (new_size > N) {
+            throw std::length_error("static vector is full");
+        }
+        if (new_size < size_) {
+            destroy_from(new_size);
+        }
+        while (size_ < new_size) {
+            emplace_back(value);
+        }
+    }
+
+    void clear() { destroy_from(0); }
+
+    void swap(StaticVectorTheSerene &other) {
+        StaticVectorTheSerene moved(std::move(other));
+        other = std::move(*this);
+        *this = std::move(moved);
+    }
+
+    bool operator==(const StaticVectorTheSerene &other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_equal(items_, other.items_, size_);
+        } else {
+            return std::equal(begin(), end(), other.begin());
+        }
+    }
+
+    auto operator<=>(const StaticVectorTheSerene &other) const {
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_compare(items_, size_, other.items_, other.size_);
+        }
+        size_t min_size = std::min(size_, other.size_);
+        for (size_t i = 0; i < min_size; ++i) {
+            if (items_[i] < other.items_[i]) {
+                return std::strong_ordering::less;
+            } else if (items_[i] > other.items_[i]) {
+                return std::strong_ordering::greater;
+            }
+        }
+        return size_ <=> other.size_;
+    }
+};
+
+// The elements are inside, so it relocates exactly when they do
+template <typename T, size_t N>
+struct is_trivially_relocatable_serene<StaticVectorTheSerene<T, N>>
+    : is_trivially_relocatable_serene<T> {};
+
+template <typename T, size_t N>
+void print_vector(const StaticVectorTheSerene<T, N> &v) {
+    for (const auto &item : v) {
+        std::cout << item << " ";
+    }
+    std::cout << std::endl;
+}
+
+#endif // INCLUDE_STATIC_VECTOR_THE_SERENE_HPP_
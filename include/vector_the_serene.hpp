@@ -1,581 +1,1047 @@
 #ifndef INCLUDE_VECTOR_THE_SERENE_HPP_
 #define INCLUDE_VECTOR_THE_SERENE_HPP_
 
+#include "./growth_policies.hpp"
+#include "./serene_checks.hpp"
+#include "./serene_compare.hpp"
+#include "./serene_stats.hpp"
+#include <algorithm>
 #include <cassert>
 #include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <new>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
-template <typename T> class VectorTheSerene {
+// Types whose objects can be moved to another address with memcpy, skipping
+// the move constructor and the destructor of the source. VectorTheSerene uses
+// a single memcpy/memmove for them when growing, inserting and erasing.
+// Specialize it for your own types that own no self-references, e.g.
+//   template <> struct is_trivially_relocatable_serene<Foo> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable_serene : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct is_trivially_relocatable_serene<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_serene_v =
+    is_trivially_relocatable_serene<T>::value;
+
+// Approximation of C++23 std::is_implicit_lifetime: types whose objects
+// come into existence on their own in suitably allocated memory, so that
+// bytes written to raw storage (e.g. by read()) are valid elements
+template <typename T>
+concept implicit_lifetime_serene =
+    std::is_trivially_destructible_v<T> &&
+    (std::is_scalar_v<T> || std::is_array_v<T> || std::is_aggregate_v<T> ||
+     std::is_trivially_default_constructible_v<T> ||
+     std::is_trivially_copy_constructible_v<T> ||
+     std::is_trivially_move_constructible_v<T>);
+
+// Alignment of the buffers an allocator hands out for T: its alignment
+// member if it has one (e.g. AllocatorTheAligned), otherwise alignof(T)
+template <typename Allocator, typename T>
+inline constexpr size_t serene_buffer_alignment = alignof(T);
+
+template <typename Allocator, typename T>
+    requires requires {
+        { Allocator::alignment } -> std::convertible_to<size_t>;
+    }
+inline constexpr size_t serene_buffer_alignment<Allocator, T> =
+    std::max(alignof(T), size_t(Allocator::alignment));
+
+// Room for N elements inside the object itself, for SmallVectorTheSerene
+template <typename T, size_t N, size_t Alignment = alignof(T)>
+struct InlineStorageTheSerene {
+    alignas(Alignment) std::byte buffer[N * sizeof(T)];
+
+    T *get() { return reinterpret_cast<T *>(buffer); }
+};
+
+template <typename T, size_t Alignment>
+struct InlineStorageTheSerene<T, 0, Alignment> {
+    constexpr T *get() { return nullptr; }
+};
+
+// GrowthPolicy decides the capacity on reallocation, see growth_policies.hpp.
+// With InlineCapacity > 0 the first InlineCapacity elements are stored inside
+// the object, and the heap is only used beyond that.
+template <typename T, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth<>, size_t InlineCapacity = 0>
+class VectorTheSerene {
   private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename alloc_traits::value_type, T>,
+                  "Allocator::value_type must be T");
+    static_assert(std::is_same_v<typename alloc_traits::pointer, T *>,
+                  "Fancy pointers are not supported");
+
     size_t size_;
     size_t capacity_;
-    // Assuming always valid:
-    T *data;
+    // nullptr while capacity_ == 0, so empty vectors never allocate. Points to
+    // inline_ while capacity_ == InlineCapacity.
+    T *data_;
+    [[no_unique_address]] Allocator alloc_;
+    [[no_unique_address]] InlineStorageTheSerene<
+        T, InlineCapacity, serene_buffer_alignment<Allocator, T>> inline_;
 
-    size_t capacity_for(size_t new_size) {
-        size_t new_capacity = std::max(capacity_, 16ul);
-        while (new_size > new_capacity) {
-            new_capacity *= 2;
+    template <typename, typename, typename, size_t>
+    friend class VectorTheSerene;
+
+    // No-ops unless VECTOR_THE_SERENE_STATS is defined
+    using stats_hooks = SereneStatsHooks<VectorTheSerene>;
+
+    constexpr bool is_inline() const {
+        if constexpr (InlineCapacity > 0) {
+            return data_ == reinterpret_cast<const T *>(inline_.buffer);
+        } else {
+            return false;
         }
-        // Never auto-shrink
-        return new_capacity;
     }
 
-    static T *data_for(size_t new_capacity) {
-        return static_cast<T *>(::operator new(sizeof(T) * new_capacity));
+    // The empty state: no allocation, but the inline buffer if there is one
+    constexpr void make_empty() noexcept {
+        size_ = 0;
+        capacity_ = InlineCapacity;
+        data_ = inline_.get();
     }
 
-    void move_into(T *new_data, size_t new_size, size_t new_capacity) {
-        assert(new_capacity >= size_);
-        try {
-            for (size_t i = 0; i < size_; ++i) {
-                new (&new_data[i]) T(std::move(data[i]));
+    constexpr size_t capacity_for(size_t new_size) {
+        if (new_size <= capacity_) {
+            // Never auto-shrink. Also keeps empty vectors allocation-free
+            return capacity_;
+        }
+        return GrowthPolicy::next_capacity(capacity_, new_size, sizeof(T));
+    }
+
+    constexpr T *data_for(size_t new_capacity) {
+        if (new_capacity <= InlineCapacity) {
+            // Only asked for while the inline buffer is free
+            return inline_.get();
+        }
+        stats_hooks::allocated(new_capacity * sizeof(T));
+        stats_hooks::capacity_changed(new_capacity);
+        return alloc_traits::allocate(alloc_, new_capacity);
+    }
+
+    constexpr void free_data(T *old_data, size_t old_capacity) {
+        if (old_data != nullptr && old_data != inline_.get()) {
+            alloc_traits::deallocate(alloc_, old_data, old_capacity);
+        }
+    }
+
+    template <typename... Args>
+    constexpr void construct(T *where, Args &&...args) {
+        alloc_traits::construct(alloc_, where, std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy(T *where) { alloc_traits::destroy(alloc_, where); }
+
+    static constexpr bool relocatable = is_trivially_relocatable_serene_v<T>;
+
+    // memcpy and memmove can't run during constant evaluation, where
+    // relocation falls back to moving the elements one by one
+    static constexpr bool relocate_bytewise() {
+        return relocatable && !std::is_constant_evaluated();
+    }
+    // Allocators like AllocatorTheVast can resize a buffer in place (e.g.
+    // with mremap), which only works if the elements need no moving
+    static constexpr bool reallocatable =
+        std::is_trivially_copyable_v<T> &&
+        requires(Allocator &alloc, T *p, size_t n) {
+            { alloc.reallocate(p, n, n) } -> std::same_as<T *>;
+        };
+
+    // Move-constructs [first, last) into raw memory at dest. If a move
+    // throws, the already constructed items are destroyed again, and the
+    // source is left as it was (apart from being moved-from).
+    constexpr void uninitialized_move(T *first, T *last, T *dest) {
+        stats_hooks::moved(last - first);
+        if (relocate_bytewise()) {
+            if (first != last) {
+                std::memcpy(static_cast<void *>(dest), first,
+                            (last - first) * sizeof(T));
             }
-            auto old_data = data;
-            auto old_size = size_;
-            data = new_data;
-            capacity_ = new_capacity;
-            size_ = new_size;
-            for (size_t i = 0; i < old_size; ++i) {
-                old_data[i].~T();
+            return;
+        }
+        T *current = dest;
+        try {
+            for (; first != last; ++first, ++current) {
+                construct(current, std::move(*first));
             }
-            ::operator delete(old_data);
         } catch (...) {
-            // Clean up any constructed objects in new_data if an exception
-            // occurs
-            for (size_t i = 0; i < size_; ++i) {
-                if (i < new_size && new_data != data) {
-                    new_data[i].~T();
-                }
+            for (; dest != current; ++dest) {
+                destroy(dest);
+            }
+            throw;
+        }
+    }
+
+    // Ends the lifetime of [first, last) after uninitialized_move
+    constexpr void destroy_moved(T *first, T *last) {
+        if (!relocate_bytewise()) {
+            for (; first != last; ++first) {
+                destroy(first);
             }
-            ::operator delete(new_data);
+        }
+    }
+
+    // Moves [first, last) to dest inside the current buffer, turning the
+    // vacated slots into raw memory. The ranges may overlap.
+    constexpr void shift(T *first, T *last, T *dest) {
+        stats_hooks::moved(last - first);
+        if (relocate_bytewise()) {
+            if (first != last) {
+                std::memmove(static_cast<void *>(dest), first,
+                             (last - first) * sizeof(T));
+            }
+        } else if (dest < first) {
+            for (; first != last; ++first, ++dest) {
+                construct(dest, std::move(*first));
+                destroy(first);
+            }
+        } else {
+            T *dest_last = dest + (last - first);
+            while (last != first) {
+                construct(--dest_last, std::move(*--last));
+                destroy(last);
+            }
+        }
+    }
+
+    constexpr void move_into(T *new_data, size_t new_capacity) {
+        assert(new_capacity >= size_);
+        try {
+            uninitialized_move(data_, data_ + size_, new_data);
+        } catch (...) {
+            free_data(new_data, new_capacity);
             throw; // Re-throw the caught exception
         }
+        if (data_ != nullptr) {
+            stats_hooks::reallocated();
+        }
+        destroy_moved(data_, data_ + size_);
+        free_data(data_, capacity_);
+        data_ = new_data;
+        capacity_ = new_capacity;
     }
 
-    void unsafe_reserve(size_t new_capacity) {
+    constexpr void unsafe_reserve(size_t new_capacity) {
+        // Never below the inline buffer
+        new_capacity = std::max(new_capacity, InlineCapacity);
         if (new_capacity == capacity_) {
             return;
         }
+        if constexpr (reallocatable) {
+            if (data_ != nullptr && new_capacity > InlineCapacity &&
+                !is_inline()) {
+                data_ = alloc_.reallocate(data_, capacity_, new_capacity);
+                capacity_ = new_capacity;
+                stats_hooks::allocated(new_capacity * sizeof(T));
+                stats_hooks::reallocated();
+                stats_hooks::capacity_changed(new_capacity);
+                return;
+            }
+        }
 
         T *new_data = data_for(new_capacity);
-        move_into(new_data, size_, new_capacity);
+        move_into(new_data, new_capacity);
     }
 
-  public:
-    using value_type = T;
-    using iterator = T *;
-    using const_iterator = const T *;
-    using reverse_iterator = std::reverse_iterator<T *>;
-    using const_reverse_iterator = std::reverse_iterator<const T *>;
-
-    void swap(VectorTheSerene &other) {
-        std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
-        std::swap(data, other.data);
-    }
+    // Inserts count items at index, constructed in place by
+    // construct_items(T *where), which has to clean up after itself if it
+    // throws. When the buffer grows, the new items are constructed before
+    // anything is moved - for cases like v.push_back(v.back()) - and the
+    // vector is left untouched on exceptions.
+    template <typename ConstructItems>
+    constexpr T *insert_with(size_t index, size_t count,
+                             ConstructItems &&construct_items) {
+        if (count > max_size() - size_) {
+            throw std::length_error("vector too long");
+        }
+        auto new_capacity = capacity_for(size_ + count);
+        if constexpr (reallocatable) {
+            if (new_capacity != capacity_ && data_ != nullptr && !is_inline()) {
+                if (count == 1) {
+                    // The item may refer to the old buffer, so build it
+                    // before the buffer goes away
+                    alignas(T) std::byte item[sizeof(T)];
+                    construct_items(reinterpret_cast<T *>(item));
+                    unsafe_reserve(new_capacity);
+                    shift(data_ + index, data_ + size_, data_ + index + 1);
+                    std::memcpy(static_cast<void *>(data_ + index), item,
+                                sizeof(T));
+                    size_++;
+                    return data_ + index;
+                }
+                unsafe_reserve(new_capacity);
+            }
+        }
+        if (new_capacity == capacity_) {
+            // Open a gap of raw memory, and close it again on failure
+            shift(data_ + index, data_ + size_, data_ + index + count);
+            try {
+                construct_items(data_ + index);
+            } catch (...) {
+                shift(data_ + index + count, data_ + size_ + count,
+                      data_ + index);
+                throw; // Re-throw the caught exception
+            }
+            size_ += count;
+            return data_ + index;
+        }
 
-    VectorTheSerene() {
-        size_ = 0;
-        capacity_ = 16;
-        data = data_for(16);
-    }
-    VectorTheSerene(const VectorTheSerene &other) {
-        size_ = other.size_;
-        capacity_ = other.capacity_;
-        data = data_for(capacity_);
+        T *new_data = data_for(new_capacity);
         try {
-            for (size_t i = 0; i < size_; ++i) {
-                // Can't just assign as this is the raw data
-                new (&data[i]) T(other.data[i]);
+            construct_items(new_data + index);
+        } catch (...) {
+            free_data(new_data, new_capacity);
+            throw; // Re-throw the caught exception
+        }
+        try {
+            uninitialized_move(data_, data_ + index, new_data);
+            try {
+                uninitialized_move(data_ + index, data_ + size_,
+                                   new_data + index + count);
+            } catch (...) {
+                if (!relocate_bytewise()) {
+                    for (size_t i = 0; i < index; ++i) {
+                        destroy(&new_data[i]);
+                    }
+                }
+                throw;
             }
         } catch (...) {
-            // Clean up any constructed objects if an exception occurs
-            for (size_t i = 0; i < size_; ++i) {
-                if (&data[i] != nullptr) {
-                    data[i].~T();
+            // Clean up the new items, the old buffer is still intact
+            if (!relocate_bytewise()) {
+                for (size_t i = 0; i < count; ++i) {
+                    destroy(&new_data[index + i]);
                 }
             }
-            ::operator delete(data);
+            free_data(new_data, new_capacity);
             throw; // Re-throw the caught exception
         }
+        if (data_ != nullptr) {
+            stats_hooks::reallocated();
+        }
+        destroy_moved(data_, data_ + size_);
+        free_data(data_, capacity_);
+        data_ = new_data;
+        capacity_ = new_capacity;
+        size_ += count;
+        return data_ + index;
     }
-    VectorTheSerene(VectorTheSerene &&other) noexcept { swap(other); }
-    VectorTheSerene &operator=(const VectorTheSerene &other) {
-        VectorTheSerene tmp(other);
-        swap(tmp);
-        return *this;
+
+    // Only contiguous ranges of T can be (part of) this vector, and then
+    // writing to the vector may change them under our feet
+    template <typename Range>
+    static constexpr bool may_alias =
+        std::ranges::contiguous_range<Range> &&
+        std::is_same_v<std::ranges::range_value_t<Range>, T>;
+
+    template <typename Range> constexpr bool aliases(Range &range) const {
+        return points_into(std::ranges::data(range));
     }
 
-    VectorTheSerene(size_t n, const T &value) : size_(n), capacity_(0) {
-        capacity_ = capacity_for(n);
+    // Whether item is in the buffer. Pointers into different objects can't
+    // be compared during constant evaluation, so there the answer is yes,
+    // and the callers take their copy-first path.
+    constexpr bool points_into(const T *item) const {
+        if (std::is_constant_evaluated()) {
+            return true;
+        }
+        return item >= data_ && item < data_ + capacity_;
+    }
 
-        data = data_for(capacity_);
+    // Constructs the count items of range at where, with a single memcpy for
+    // contiguous ranges of trivially copyable items
+    template <typename Range>
+    constexpr void construct_range(T *where, Range &range, size_t count) {
+        using reference = std::ranges::range_reference_t<Range>;
+        if constexpr (std::is_lvalue_reference_v<reference>) {
+            stats_hooks::copied(count);
+        } else {
+            stats_hooks::moved(count);
+        }
+        if constexpr (std::ranges::contiguous_range<Range> &&
+                      std::is_same_v<std::remove_cvref_t<reference>, T> &&
+                      std::is_trivially_copyable_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                std::memcpy(static_cast<void *>(where),
+                            std::ranges::data(range), count * sizeof(T));
+                return;
+            }
+        }
+        size_t i = 0;
         try {
-            for (size_t i = 0; i < size_; ++i) {
-                new (&data[i]) T(value);
+            for (auto it = std::ranges::begin(range); i < count; ++i, ++it) {
+                construct(&where[i], *it);
             }
         } catch (...) {
-            // Clean up any constructed objects if an exception occurs
-            for (size_t i = 0; i < size_; ++i) {
-                if (&data[i] != nullptr) {
-                    data[i].~T();
-                }
+            for (size_t j = 0; j < i; ++j) {
+                destroy(&where[j]);
             }
-            ::operator delete(data);
-            throw; // Re-throw the caught exception
+            throw;
         }
     }
-    template <typename Iterator> VectorTheSerene(Iterator begin, Iterator end) {
-        size_ = std::distance(begin, end);
-        capacity_ = capacity_for(size_);
-        data = data_for(capacity_);
+
+    // Copies [begin, begin + count) into freshly allocated storage, leaving
+    // the vector empty if any of the copies throws
+    template <typename Iterator>
+    constexpr void init_from(Iterator begin, size_t count) {
+        make_empty();
+        capacity_ = capacity_for(count);
+        data_ = data_for(capacity_);
+        if constexpr (std::is_lvalue_reference_v<decltype(*begin)>) {
+            stats_hooks::copied(count);
+        } else {
+            stats_hooks::moved(count);
+        }
+        if constexpr (std::is_trivially_copyable_v<T> &&
+                      std::is_pointer_v<Iterator>) {
+            if (!std::is_constant_evaluated()) {
+                if (count != 0) {
+                    std::memcpy(static_cast<void *>(data_), begin,
+                                count * sizeof(T));
+                }
+                size_ = count;
+                return;
+            }
+        }
         try {
-            for (size_t i = 0; i < size_; ++i) {
-                new (&data[i]) T(*(begin + i));
+            for (; size_ < count; ++size_, ++begin) {
+                // Can't just assign as this is the raw data
+                construct(&data_[size_], *begin);
             }
         } catch (...) {
             // Clean up any constructed objects if an exception occurs
             for (size_t i = 0; i < size_; ++i) {
-                if (&data[i] != nullptr) {
-                    data[i].~T();
-                }
+                destroy(&data_[i]);
             }
-            ::operator delete(data);
+            free_data(data_, capacity_);
+            make_empty();
             throw; // Re-throw the caught exception
         }
     }
-    VectorTheSerene(std::initializer_list<T> list) {
-        size_ = list.size();
-        capacity_ = capacity_for(size_);
-        data = data_for(capacity_);
-        try {
-            size_t i = 0;
-            for (const auto &item : list) {
-                new (&data[i++]) T(item);
+
+    constexpr void release_storage() {
+        for (size_t i = 0; i < size_; ++i)
+            destroy(&data_[i]);
+        free_data(data_, capacity_);
+        make_empty();
+    }
+
+    // Inline elements are moved and swapped when storage changes hands,
+    // which only can't throw if that can't
+    static constexpr bool nothrow_storage_swap =
+        InlineCapacity == 0 || (std::is_nothrow_move_constructible_v<T> &&
+                                std::is_nothrow_swappable_v<T>);
+
+    // Exchanges everything except the allocator. Inline elements can't
+    // change owners, so they are moved over one by one.
+    constexpr void
+    swap_storage(VectorTheSerene &other) noexcept(nothrow_storage_swap) {
+        if constexpr (InlineCapacity > 0) {
+            if (other.is_inline() && !is_inline()) {
+                other.swap_storage(*this);
+                return;
             }
-        } catch (...) {
-            // Clean up any constructed objects if an exception occurs
-            for (size_t i = 0; i < size_; ++i) {
-                if (&data[i] != nullptr) {
-                    data[i].~T();
+            if (is_inline() && other.is_inline()) {
+                VectorTheSerene &longer = size_ > other.size_ ? *this : other;
+                VectorTheSerene &shorter = size_ > other.size_ ? other : *this;
+                size_t common = shorter.size_;
+                for (size_t i = 0; i < common; ++i) {
+                    std::swap(data_[i], other.data_[i]);
                 }
+                longer.uninitialized_move(longer.data_ + common,
+                                          longer.data_ + longer.size_,
+                                          shorter.data_ + common);
+                longer.destroy_moved(longer.data_ + common,
+                                     longer.data_ + longer.size_);
+                std::swap(size_, other.size_);
+                return;
+            }
+            if (is_inline()) {
+                // Our elements go to other's inline buffer, its heap buffer
+                // comes to us
+                T *heap_data = other.data_;
+                size_t heap_size = other.size_;
+                size_t heap_capacity = other.capacity_;
+                other.make_empty();
+                uninitialized_move(data_, data_ + size_, other.data_);
+                destroy_moved(data_, data_ + size_);
+                other.size_ = size_;
+                data_ = heap_data;
+                size_ = heap_size;
+                capacity_ = heap_capacity;
+                return;
             }
-            ::operator delete(data);
-            throw; // Re-throw the caught exception
         }
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(data_, other.data_);
     }
 
-    VectorTheSerene &operator=(VectorTheSerene &&other) noexcept {
-        swap(other);
-        return *this;
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<T *>;
+    using const_reverse_iterator = std::reverse_iterator<const T *>;
+
+    // Guaranteed alignment of data()
+    static constexpr size_t alignment = serene_buffer_alignment<Allocator, T>;
+
+    constexpr allocator_type get_allocator() const { return alloc_; }
+
+    // Usage statistics of this vector type (all zeros unless
+    // VECTOR_THE_SERENE_STATS is defined), see serene_stats.hpp
+    static SereneStatsSnapshot stats() {
+        if constexpr (serene_stats_enabled) {
+            return serene_stats_for<VectorTheSerene>().snapshot();
+        } else {
+            return {};
+        }
     }
-    ~VectorTheSerene() {
-        for (size_t i = 0; i < size_; ++i)
-            data[i].~T();
-        ::operator delete(data);
+    static void reset_stats() {
+        if constexpr (serene_stats_enabled) {
+            serene_stats_for<VectorTheSerene>().reset();
+        }
     }
 
-    T &operator[](size_t index) { return data[index]; }
-    const T &operator[](size_t index) const { return data[index]; }
-    const T &at(size_t index) const {
-        if (index >= size_) { // not < 0, because size_t
-            throw std::out_of_range("index out of range");
+    constexpr void swap(VectorTheSerene &other) noexcept(nothrow_storage_swap) {
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            // Swapping vectors with unequal, non-propagating allocators is
+            // undefined, same as for std::vector
+            assert(alloc_ == other.alloc_);
         }
-        return data[index];
+        swap_storage(other);
     }
-    T &at(size_t index) {
-        return const_cast<T &>(
-            static_cast<const VectorTheSerene<T> *>(this)->at(index));
+
+    constexpr VectorTheSerene() noexcept(noexcept(Allocator()))
+        : VectorTheSerene(Allocator()) {}
+    // The first allocation is deferred until the first insertion
+    explicit constexpr VectorTheSerene(const Allocator &alloc) noexcept
+        : alloc_(alloc) {
+        make_empty();
+    }
+    constexpr VectorTheSerene(const VectorTheSerene &other)
+        : VectorTheSerene(
+              other,
+              alloc_traits::select_on_container_copy_construction(
+                  other.alloc_)) {}
+    constexpr VectorTheSerene(const VectorTheSerene &other,
+                              const Allocator &alloc)
+        : alloc_(alloc) {
+        init_from(other.data_, other.size_);
+    }
+    // Leaves other empty and allocation-free
+    constexpr VectorTheSerene(VectorTheSerene &&other) noexcept(
+        nothrow_storage_swap)
+        : alloc_(std::move(other.alloc_)) {
+        make_empty();
+        swap_storage(other);
+    }
+    constexpr VectorTheSerene(VectorTheSerene &&other, const Allocator &alloc)
+        : alloc_(alloc) {
+        make_empty();
+        if (alloc_ == other.alloc_) {
+            swap_storage(other);
+        } else {
+            // The storage belongs to another allocator, so only the elements
+            // themselves can be moved over
+            init_from(std::make_move_iterator(other.data_), other.size_);
+        }
+    }
+    constexpr VectorTheSerene &operator=(const VectorTheSerene &other) {
+        if (this == &other) {
+            return *this;
+        }
+        constexpr bool propagate =
+            alloc_traits::propagate_on_container_copy_assignment::value;
+        VectorTheSerene tmp(other, propagate ? other.alloc_ : alloc_);
+        swap_storage(tmp);
+        if constexpr (propagate) {
+            // tmp now owns our old storage, so it has to free it with the old
+            // allocator
+            std::swap(alloc_, tmp.alloc_);
+        }
+        return *this;
     }
 
-    void push_back(const T &value) {
-        auto new_capacity = capacity_for(size_ + 1);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
+    constexpr VectorTheSerene(size_t n, const T &value,
+                              const Allocator &alloc = Allocator())
+        : alloc_(alloc) {
+        make_empty();
+        capacity_ = capacity_for(n);
+        data_ = data_for(capacity_);
+        size_ = n;
+        stats_hooks::copied(n);
+        size_t constructed = 0;
         try {
-            new (&target_data[size_])
-                T(value); // First construct the new item - for cases like
-                          // v.push_back(v.back())
-            if (new_capacity != capacity_) {
-                move_into(target_data, size_ + 1, new_capacity);
-            } else {
-                size_++;
+            for (; constructed < size_; ++constructed) {
+                construct(&data_[constructed], value);
             }
         } catch (...) {
-            if (new_capacity != capacity_) {
-                ::operator delete(target_data);
+            // Clean up any constructed objects if an exception occurs
+            for (size_t i = 0; i < constructed; ++i) {
+                destroy(&data_[i]);
             }
+            free_data(data_, capacity_);
+            make_empty();
             throw; // Re-throw the caught exception
         }
     }
-    void push_back(T &&value) {
-        auto new_capacity = capacity_for(size_ + 1);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
-        try {
-            new (&target_data[size_]) T(std::move(value));
-            if (new_capacity != capacity_) {
-                move_into(target_data, size_ + 1, new_capacity);
-            } else {
-                size_++;
-            }
-        } catch (...) {
-            if (new_capacity != capacity_) {
-                ::operator delete(target_data);
-            }
-            throw; // Re-throw the caught exception
+    template <std::forward_iterator Iterator>
+    constexpr VectorTheSerene(Iterator begin, Iterator end,
+                              const Allocator &alloc = Allocator())
+        : alloc_(alloc) {
+        init_from(begin, std::distance(begin, end));
+    }
+    constexpr VectorTheSerene(std::initializer_list<T> list,
+                              const Allocator &alloc = Allocator())
+        : alloc_(alloc) {
+        init_from(list.begin(), list.size());
+    }
+
+    constexpr VectorTheSerene &operator=(VectorTheSerene &&other) noexcept(
+        nothrow_storage_swap &&
+        (alloc_traits::propagate_on_container_move_assignment::value ||
+         alloc_traits::is_always_equal::value)) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            // Release our storage while we still have the allocator it came
+            // from, then take over both the storage and the allocator
+            release_storage();
+            alloc_ = std::move(other.alloc_);
+            swap_storage(other);
+        } else if (alloc_ == other.alloc_) {
+            release_storage();
+            swap_storage(other);
+        } else {
+            // Unequal allocators that don't propagate: move element-wise into
+            // storage from our own allocator
+            VectorTheSerene tmp(std::move(other), alloc_);
+            swap_storage(tmp);
         }
+        return *this;
     }
+    constexpr ~VectorTheSerene() { release_storage(); }
 
-    void pop_back() {
+    // Only checked at the hardened and assert levels, see serene_checks.hpp
+    constexpr T &operator[](size_t index) {
+        serene_check_index(index < size_);
+        return data_[index];
+    }
+    constexpr const T &operator[](size_t index) const {
+        serene_check_index(index < size_);
+        return data_[index];
+    }
+    constexpr const T &at(size_t index) const {
+        if (index >= size_) { // not < 0, because size_t
+            throw std::out_of_range("index out of range");
+        }
+        return data_[index];
+    }
+    constexpr T &at(size_t index) {
+        return const_cast<T &>(
+            static_cast<const VectorTheSerene *>(this)->at(index));
+    }
+
+    constexpr void push_back(const T &value) { emplace_back(value); }
+    constexpr void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    constexpr void pop_back() {
         if (size_ > 0) {
             size_--;
-            data[size_].~T();
+            destroy(&data_[size_]);
         }
     }
 
-    template <typename... Args> T &emplace_back(Args &&...args) {
-        auto new_capacity = capacity_for(size_ + 1);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
-        try {
-            new (&target_data[size_]) T(std::forward<Args>(args)...);
-            if (new_capacity != capacity_) {
-                move_into(target_data, size_ + 1, new_capacity);
-            } else {
-                size_++;
-            }
-            return target_data[size_ - 1];
-        } catch (...) {
-            if (new_capacity != capacity_) {
-                ::operator delete(target_data);
-            }
-            throw; // Re-throw the caught exception
-        }
+    template <typename... Args> constexpr T &emplace_back(Args &&...args) {
+        stats_hooks::template constructed<Args...>();
+        return *insert_with(size_, 1, [&](T *where) {
+            construct(where, std::forward<Args>(args)...);
+        });
     }
 
-    T &back() {
-        if (size_ == 0) {
-            throw std::out_of_range("vector is empty");
-        }
-        return data[size_ - 1];
+    constexpr T &back() {
+        serene_check(size_ != 0, "vector is empty");
+        return data_[size_ - 1];
     }
-    const T &back() const {
-        if (size_ == 0) {
-            throw std::out_of_range("vector is empty");
-        }
-        return data[size_ - 1];
+    constexpr const T &back() const {
+        serene_check(size_ != 0, "vector is empty");
+        return data_[size_ - 1];
     }
-    T &front() {
-        if (size_ == 0) {
-            throw std::out_of_range("vector is empty");
-        }
-        return data[0];
+    constexpr T &front() {
+        serene_check(size_ != 0, "vector is empty");
+        return data_[0];
     }
-    const T &front() const {
-        if (size_ == 0) {
-            throw std::out_of_range("vector is empty");
-        }
-        return data[0];
+    constexpr const T &front() const {
+        serene_check(size_ != 0, "vector is empty");
+        return data_[0];
+    }
+
+    // The elements, at an address aligned to alignment, e.g. for SIMD loads.
+    // nullptr while nothing was allocated.
+    constexpr T *data() { return std::assume_aligned<alignment>(data_); }
+    constexpr const T *data() const {
+        return std::assume_aligned<alignment>(data_);
     }
 
-    T *begin() { return data; }
-    T *end() { return data + size_; }
+    constexpr T *begin() { return data_; }
+    constexpr T *end() { return data_ + size_; }
 
-    const T *begin() const { return data; }
-    const T *end() const { return data + size_; }
+    constexpr const T *begin() const { return data_; }
+    constexpr const T *end() const { return data_ + size_; }
 
-    const T *cbegin() const { return data; }
-    const T *cend() const { return data + size_; }
+    constexpr const T *cbegin() const { return data_; }
+    constexpr const T *cend() const { return data_ + size_; }
 
-    std::reverse_iterator<T *> rbegin() {
+    constexpr std::reverse_iterator<T *> rbegin() {
         return std::reverse_iterator<T *>(end());
     }
-    std::reverse_iterator<T *> rend() {
+    constexpr std::reverse_iterator<T *> rend() {
         return std::reverse_iterator<T *>(begin());
     }
 
-    std::reverse_iterator<const T *> rbegin() const {
+    constexpr std::reverse_iterator<const T *> rbegin() const {
         return std::reverse_iterator<const T *>(end());
     }
-    std::reverse_iterator<const T *> rend() const {
+    constexpr std::reverse_iterator<const T *> rend() const {
         return std::reverse_iterator<const T *>(begin());
     }
 
-    std::reverse_iterator<const T *> crbegin() const {
+    constexpr std::reverse_iterator<const T *> crbegin() const {
         return std::reverse_iterator<const T *>(cend());
     }
-    std::reverse_iterator<const T *> crend() const {
+    constexpr std::reverse_iterator<const T *> crend() const {
         return std::reverse_iterator<const T *>(cbegin());
     }
 
-    size_t size() const { return size_; }
-    size_t capacity() const { return capacity_; }
+    constexpr size_t size() const { return size_; }
+    constexpr size_t capacity() const { return capacity_; }
+    constexpr size_t max_size() const {
+        return std::min<size_t>(alloc_traits::max_size(alloc_),
+                                PTRDIFF_MAX / sizeof(T));
+    }
 
-    bool is_empty() const { return size_ == 0; }
-    bool empty() const { return size_ == 0; }
-    void clear() {
+    constexpr bool is_empty() const { return size_ == 0; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr void clear() {
         for (size_t i = 0; i < size_; ++i) {
-            data[i].~T();
+            destroy(&data_[i]);
         }
+        // Keep the capacity, same as std::vector
         size_ = 0;
-        unsafe_reserve(capacity_for(0));
     }
 
-    void reserve(size_t new_capacity) {
+    constexpr void reserve(size_t new_capacity) {
         if (new_capacity > capacity_) {
             unsafe_reserve(new_capacity);
         }
     }
-    void shrink_to_fit() {
+    constexpr void shrink_to_fit() {
         if (size_ < capacity_) {
             unsafe_reserve(size_);
         }
     }
 
-    void resize(size_t new_size) {
+    constexpr void resize(size_t new_size) {
         // Remove all the items >=new_size
         for (size_t i = new_size; i < size_; ++i) {
-            data[i].~T();
+            destroy(&data_[i]);
+        }
+        if (new_size < size_) {
+            size_ = new_size;
         }
         unsafe_reserve(capacity_for(new_size));
         // Add new items
+        size_t i = size_;
         try {
-            for (size_t i = size_; i < new_size; ++i) {
-                new (&data[i]) T();
+            for (; i < new_size; ++i) {
+                construct(&data_[i]);
             }
             size_ = new_size;
         } catch (...) {
             // If an exception occurs during construction, we need to clean up
             // and maintain a consistent state
-            for (size_t i = size_; i < new_size; ++i) {
-                if (&data[i] != nullptr) {
-                    try {
-                        data[i].~T();
-                    } catch (...) {
-                        // Ignore exceptions in destructors
-                    }
-                }
+            for (size_t j = size_; j < i; ++j) {
+                destroy(&data_[j]);
             }
             throw; // Re-throw the exception
         }
     }
-    void resize(size_t new_size, const T &value) {
+    constexpr void resize(size_t new_size, const T &value) {
         // Remove all the items >=new_size
         for (size_t i = new_size; i < size_; ++i) {
-            data[i].~T();
+            destroy(&data_[i]);
+        }
+        if (new_size < size_) {
+            size_ = new_size;
         }
         unsafe_reserve(capacity_for(new_size));
         // Add new items
+        size_t i = size_;
+        stats_hooks::copied(new_size - i);
         try {
-            for (size_t i = size_; i < new_size; ++i) {
-                new (&data[i]) T(value);
+            for (; i < new_size; ++i) {
+                construct(&data_[i], value);
             }
             size_ = new_size;
         } catch (...) {
             // If an exception occurs during construction, we need to clean up
-            for (size_t i = size_; i < new_size; ++i) {
-                if (&data[i] != nullptr) {
-                    try {
-                        data[i].~T();
-                    } catch (...) {
-                        // Ignore exceptions in destructors
-                    }
-                }
+            for (size_t j = size_; j < i; ++j) {
+                destroy(&data_[j]);
             }
             throw; // Re-throw the exception
         }
     }
 
-    iterator insert(const_iterator pos, const T &value) {
-        size_t index = pos - data;
-        if (index > size_) {
-            throw std::out_of_range("index out of range");
+    // Like resize(), but the new elements are default-initialized instead of
+    // value-initialized, i.e. left with indeterminate values for types like
+    // int. Doesn't go through the allocator's construct().
+    void resize_default_init(size_t new_size)
+        requires std::default_initializable<T>
+    {
+        for (size_t i = new_size; i < size_; ++i) {
+            destroy(&data_[i]);
         }
-
-        // TODO inserting part of self
-        auto new_capacity = capacity_for(size_ + 1);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
-        try {
-            for (size_t i = size_ - 1; i > index; --i) {
-                new (&target_data[i]) T(std::move(data[i - 1]));
-                data[i - 1].~T();
-            }
-            new (&target_data[index]) T(value);
-
-            if (new_capacity != capacity_) {
-                auto future_size = size_ + 1;
-                size_ = index; // Since the rest was moved manually
-                move_into(target_data, future_size, new_capacity);
-                // If move_into fails, the vector has the shortened size, and of
-                // course a memory leak happens, but it's still usable
-            } else {
-                size_++;
-            }
-        } catch (...) {
-            // Clean up any allocated memory and constructed objects
-            if (new_capacity != capacity_) {
-                for (size_t i = 0; i < size_ && i != index; ++i) {
-                    if (&target_data[i] != nullptr) {
-                        try {
-                            target_data[i].~T();
-                        } catch (...) {
-                            // Ignore exceptions in destructors
-                        }
-                    }
+        if (new_size < size_) {
+            size_ = new_size;
+        }
+        unsafe_reserve(capacity_for(new_size));
+        if constexpr (std::is_trivially_default_constructible_v<T>) {
+            // Nothing to run
+            size_ = new_size;
+        } else {
+            size_t i = size_;
+            try {
+                for (; i < new_size; ++i) {
+                    ::new (static_cast<void *>(&data_[i])) T;
                 }
-                ::operator delete(target_data);
+                size_ = new_size;
+            } catch (...) {
+                for (size_t j = size_; j < i; ++j) {
+                    destroy(&data_[j]);
+                }
+                throw; // Re-throw the exception
             }
-            throw; // Re-throw the caught exception
         }
+    }
 
-        return data + index;
+    // Grows or shrinks to new_size without touching the new elements at
+    // all, not even running a constructor. Their values are whatever is in
+    // memory until they are written, e.g. buffer.resize_uninitialized(n) and
+    // then read(fd, buffer.begin(), n).
+    void resize_uninitialized(size_t new_size)
+        requires implicit_lifetime_serene<T>
+    {
+        unsafe_reserve(capacity_for(new_size));
+        size_ = new_size;
     }
 
-    iterator insert(const_iterator pos, T &&value) {
-        size_t index = pos - data;
-        if (index > size_) {
-            throw std::out_of_range("index out of range");
+    // Like std::string::resize_and_overwrite: makes room for at least n
+    // elements, calls op(data, n) to write them and keeps the first
+    // op(...) elements, which must be at most n. Elements past the old
+    // size are uninitialized when op is called. If op throws, the size is
+    // not changed.
+    template <typename Operation>
+    void resize_and_overwrite(size_t n, Operation op)
+        requires implicit_lifetime_serene<T> &&
+                 std::is_invocable_r_v<size_t, Operation &, T *, size_t>
+    {
+        unsafe_reserve(capacity_for(n));
+        size_t new_size = op(data_, n);
+        assert(new_size <= n);
+        size_ = new_size;
+    }
+
+    constexpr iterator insert(const_iterator pos, const T &value) {
+        size_t index = pos - data_;
+        serene_check(index <= size_, "index out of range");
+        if (points_into(&value)) {
+            // Inserting part of self - the value would be shifted away
+            T copy(value);
+            return insert(pos, std::move(copy));
         }
 
-        auto new_capacity = capacity_for(size_ + 1);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
-        try {
-            for (size_t i = size_; i > index; --i) {
-                new (&target_data[i]) T(std::move(data[i - 1]));
-                data[i - 1].~T();
-            }
-            new (&target_data[index]) T(std::move(value));
+        stats_hooks::copied(1);
+        return insert_with(index, 1,
+                           [&](T *where) { construct(where, value); });
+    }
 
-            if (new_capacity != capacity_) {
-                auto future_size = size_ + 1;
-                size_ = index; // Since the rest was moved manually
-                move_into(target_data, future_size, new_capacity);
-            } else {
-                size_++;
-            }
-        } catch (...) {
-            // Clean up any allocated memory and constructed objects
-            if (new_capacity != capacity_) {
-                for (size_t i = 0; i < size_ && i != index; ++i) {
-                    if (&target_data[i] != nullptr) {
-                        try {
-                            target_data[i].~T();
-                        } catch (...) {
-                            // Ignore exceptions in destructors
-                        }
-                    }
-                }
-                ::operator delete(target_data);
-            }
-            throw; // Re-throw the caught exception
-        }
+    constexpr iterator insert(const_iterator pos, T &&value) {
+        size_t index = pos - data_;
+        serene_check(index <= size_, "index out of range");
+        stats_hooks::moved(1);
 
-        return data + index;
+        return insert_with(index, 1, [&](T *where) {
+            construct(where, std::move(value));
+        });
     }
 
     template <typename Iterator>
-    iterator insert(const_iterator pos, Iterator begin, Iterator end) {
-        size_t index = pos - data;
-        if (index > size_) {
-            throw std::out_of_range("index out of range");
-        }
+    constexpr iterator insert(const_iterator pos, Iterator begin,
+                              Iterator end) {
+        size_t index = pos - data_;
+        serene_check(index <= size_, "index out of range");
         size_t count = std::distance(begin, end);
 
         if (count == 0) {
-            return data + index;
+            return data_ + index;
         }
 
-        auto new_capacity = capacity_for(size_ + count);
-        auto target_data =
-            new_capacity == capacity_ ? data : data_for(new_capacity);
-        try {
-            if (size_ > 0) {
-                for (size_t i = size_ - 1; i >= index; --i) {
-                    new (&target_data[i + count]) T(std::move(data[i]));
-                    data[i].~T();
+        stats_hooks::copied(count);
+        return insert_with(index, count, [&](T *where) {
+            size_t i = 0;
+            try {
+                for (; i < count; ++i) {
+                    construct(&where[i], *(begin + i));
                 }
+            } catch (...) {
+                for (size_t j = 0; j < i; ++j) {
+                    destroy(&where[j]);
+                }
+                throw;
             }
-            for (size_t i = 0; i < count; ++i) {
-                new (&target_data[index + i]) T(*(begin + i));
-            }
+        });
+    }
 
-            if (new_capacity != capacity_) {
-                auto future_size = size_ + count;
-                size_ = index; // Since the rest was moved manually
-                move_into(target_data, future_size, new_capacity);
-            } else {
-                size_ += count;
+    // Inserts the items of any range before pos. If the size of the range is
+    // known, the buffer grows at most once and the items are constructed in
+    // bulk; single-pass ranges are appended one by one and rotated into
+    // place. On exceptions the vector is left as it was.
+    template <std::ranges::input_range Range>
+    constexpr iterator insert_range(const_iterator pos, Range &&range) {
+        size_t index = pos - data_;
+        serene_check(index <= size_, "index out of range");
+        if constexpr (may_alias<Range>) {
+            if (aliases(range)) {
+                // Part of self - it would be shifted away
+                const T *first = std::ranges::data(range);
+                VectorTheSerene copy(
+                    first, first + std::ranges::distance(range), alloc_);
+                return insert_range(data_ + index,
+                                    std::ranges::subrange(
+                                        std::make_move_iterator(copy.begin()),
+                                        std::make_move_iterator(copy.end())));
             }
-        } catch (...) {
-            // Clean up any allocated memory and constructed objects
-            if (new_capacity != capacity_) {
-                for (size_t i = 0; i < size_ && i != index; ++i) {
-                    if (&target_data[i] != nullptr) {
-                        try {
-                            target_data[i].~T();
-                        } catch (...) {
-                            // Ignore exceptions in destructors
-                        }
-                    }
+        }
+        if constexpr (std::ranges::forward_range<Range> ||
+                      std::ranges::sized_range<Range>) {
+            size_t count = size_t(std::ranges::distance(range));
+            if (count == 0) {
+                return data_ + index;
+            }
+            return insert_with(index, count, [&](T *where) {
+                construct_range(where, range, count);
+            });
+        } else {
+            size_t old_size = size_;
+            try {
+                for (auto it = std::ranges::begin(range);
+                     it != std::ranges::end(range); ++it) {
+                    emplace_back(*it);
                 }
-                ::operator delete(target_data);
+            } catch (...) {
+                while (size_ > old_size) {
+                    pop_back();
+                }
+                throw;
             }
-            throw; // Re-throw the caught exception
+            std::rotate(data_ + index, data_ + old_size, data_ + size_);
+            return data_ + index;
         }
+    }
 
-        return data + index;
+    template <std::ranges::input_range Range>
+    constexpr void append_range(Range &&range) {
+        insert_range(data_ + size_, std::forward<Range>(range));
     }
 
-    iterator erase(const_iterator pos) {
-        size_t index = pos - data;
-        if (index >= size_) {
-            throw std::out_of_range("index out of range");
-        }
-        data[index].~T();
-        for (size_t i = index + 1; i < size_; ++i) {
-            new (&data[i - 1]) T(std::move(data[i]));
-            data[i].~T();
+    // Replaces the contents with the items of range, reusing the buffer
+    template <std::ranges::input_range Range>
+    constexpr void assign_range(Range &&range) {
+        if constexpr (may_alias<Range>) {
+            if (aliases(range)) {
+                const T *first = std::ranges::data(range);
+                *this = VectorTheSerene(
+                    first, first + std::ranges::distance(range), alloc_);
+                return;
+            }
         }
+        clear();
+        append_range(std::forward<Range>(range));
+    }
+
+    constexpr iterator erase(const_iterator pos) {
+        size_t index = pos - data_;
+        serene_check(index < size_, "index out of range");
+        destroy(&data_[index]);
+        shift(data_ + index + 1, data_ + size_, data_ + index);
         size_--;
-        return data + index;
+        return data_ + index;
     }
 
-    iterator erase(const_iterator begin, const_iterator end) {
-        size_t first = begin - data;
-        size_t last = end - data;
+    constexpr iterator erase(const_iterator begin, const_iterator end) {
+        size_t first = begin - data_;
+        size_t last = end - data_;
 
-        if (first >= size_ || last > size_ || first >= last || begin < data ||
-            end < data) {
-            throw std::out_of_range("index out of range");
-        }
+        serene_check(first < size_ && last <= size_ && first < last &&
+                         begin >= data_ && end >= data_,
+                     "index out of range");
 
         for (size_t i = first; i < last; ++i) {
-            data[i].~T();
+            destroy(&data_[i]);
         }
-        size_t count = last - first;
-        for (size_t i = last; i < size_; ++i) {
-            new (&data[i - count]) T(std::move(data[i]));
-            data[i].~T();
+        // A single memmove for relocatable types
+        shift(data_ + last, data_ + size_, data_ + first);
+        size_ -= last - first;
+        return data_ + first;
+    }
+
+    constexpr bool operator==(const VectorTheSerene &other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_equal(data_, other.data_, size_);
+        } else {
+            for (size_t i = 0; i < size_; ++i) {
+                if (!(data_[i] == other.data_[i])) {
+                    return false;
+                }
+            }
+            return true;
         }
-        size_ -= count;
-        return data + first;
     }
 
-    auto operator<=>(const VectorTheSerene &other) const {
+    constexpr auto operator<=>(const VectorTheSerene &other) const {
+        if constexpr (is_bytewise_comparable_serene<T>) {
+            return serene_compare(data_, size_, other.data_, other.size_);
+        }
         size_t min_size = std::min(size_, other.size_);
         for (size_t i = 0; i < min_size; ++i) {
-            if (data[i] < other.data[i]) {
+            if (data_[i] < other.data_[i]) {
                 return std::strong_ordering::less;
-            } else if (data[i] > other.data[i]) {
+            } else if (data_[i] > other.data_[i]) {
                 return std::strong_ordering::greater;
             }
         }
@@ -583,15 +1049,32 @@ template <typename T> class VectorTheSerene {
     }
 };
 
-template <typename T> void print_vector(const VectorTheSerene<T> &v) {
+// Only pointers and sizes inside, so relocatable as long as the allocator is
+template <typename T, typename Allocator, typename GrowthPolicy,
+          size_t InlineCapacity>
+struct is_trivially_relocatable_serene<
+    VectorTheSerene<T, Allocator, GrowthPolicy, InlineCapacity>>
+    : std::bool_constant<InlineCapacity == 0 &&
+                         (std::is_empty_v<Allocator> ||
+                          std::is_trivially_copyable_v<Allocator>)> {};
+
+template <typename T, typename Allocator, typename GrowthPolicy,
+          size_t InlineCapacity>
+void print_vector(
+    const VectorTheSerene<T, Allocator, GrowthPolicy, InlineCapacity> &v) {
     for (size_t i = 0; i < v.size(); ++i) {
         std::cout << v[i] << " ";
     }
     std::cout << std::endl;
 }
 
-template <typename T>
-void print_vector(const VectorTheSerene<VectorTheSerene<T>> &v) {
+template <typename T, typename InnerAllocator, typename InnerGrowthPolicy,
+          size_t InnerInlineCapacity, typename Allocator,
+          typename GrowthPolicy, size_t InlineCapacity>
+void print_vector(
+    const VectorTheSerene<VectorTheSerene<T, InnerAllocator, InnerGrowthPolicy,
+                                          InnerInlineCapacity>,
+                          Allocator, GrowthPolicy, InlineCapacity> &v) {
     for (size_t i = 0; i < v.size(); ++i) {
         print_vector(v[i]);
     }
@@ -599,4 +1082,16 @@ void print_vector(const VectorTheSerene<VectorTheSerene<T>> &v) {
 
 template <typename T> using my_vector = VectorTheSerene<T>;
 
+// Keeps up to N elements inline and only goes to the heap beyond that
+template <typename T, size_t N, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth<>>
+using SmallVectorTheSerene = VectorTheSerene<T, Allocator, GrowthPolicy, N>;
+
+namespace pmr {
+// Same as std::pmr::vector - the memory resource is picked at runtime
+template <typename T>
+using VectorTheSerene =
+    ::VectorTheSerene<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
 #endif // INCLUDE_VECTOR_THE_SERENE_HPP_
@@ -1,10 +1,27 @@
+#include "./allocator_the_aligned.hpp"
+#include "./arena_the_frugal.hpp"
 #include "./array_the_steadfast.hpp"
+#include "./concurrent_vector_the_serene.hpp"
+#include "./flat_map_the_serene.hpp"
+#include "./flat_set_the_serene.hpp"
+#include "./hash_map_the_serene.hpp"
+#include "./jagged_vector_the_serene.hpp"
+#include "./parallel_the_swift.hpp"
+#include "./ring_the_serene.hpp"
+#include "./segmented_vector_the_serene.hpp"
+#include "./serene_serialize.hpp"
+#include "./soa_vector_the_serene.hpp"
+#include "./static_vector_the_serene.hpp"
 #include "./vector_the_serene.hpp"
 #include <algorithm>
 #include <compare>
 #include <iostream>
 #include <numeric>
+#include <ranges>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 // To check for extra operations
@@ -178,6 +195,13 @@ void test_vector_functionality() {
             }
             std::cout << std::endl;
         }
+
+        JaggedVectorTheSerene<int> jagged(vv);
+        jagged.push_row({7});
+        jagged.push_to_last_row(8);
+        std::cout << "Same rows, flattened (" << jagged.total_size()
+                  << " values in one buffer):\n";
+        print_vector(jagged);
     }
 
     std::cout << "\n=== Using with STL Algorithms ===\n";
@@ -197,12 +221,52 @@ void test_vector_functionality() {
     std::cout << std::endl;
 }
 
+// Built by the compiler: the vector only lives during constant evaluation,
+// and the array ends up in .rodata
+constexpr ArrayTheSteadfast<int, 10> first_primes() {
+    VectorTheSerene<int> primes;
+    for (int n = 2; primes.size() < 10; ++n) {
+        bool prime = true;
+        for (int p : primes) {
+            prime = prime && n % p != 0;
+        }
+        if (prime) {
+            primes.push_back(n);
+        }
+    }
+    ArrayTheSteadfast<int, 10> result;
+    std::copy(primes.begin(), primes.end(), result.begin());
+    return result;
+}
+
+constexpr auto kPrimes = first_primes();
+static_assert(kPrimes.back() == 29);
+
+// Inserting values and ranges from outside the vector, which at run time
+// are checked for being part of it
+constexpr bool splices_in_constexpr() {
+    int zero = 0;
+    ArrayTheSteadfast<int, 3> middle = {4, 5, 6};
+    VectorTheSerene<int> v = {1, 9};
+    v.insert(v.begin(), zero);
+    v.insert_range(v.begin() + 2, middle);
+    v.append_range(middle);
+    VectorTheSerene<int> copy;
+    copy.assign_range(v);
+    return copy == VectorTheSerene<int>{0, 1, 4, 5, 6, 9, 4, 5, 6};
+}
+
+static_assert(splices_in_constexpr());
+
 void test_array_functionality() {
     std::cout << "\n=== ArrayTheSteadfast Basic Operations ===\n";
     ArrayTheSteadfast<int, 5> arr = {1, 2, 3, 4, 5};
     std::cout << "Array after initialization: ";
     print_array(arr);
 
+    std::cout << "Primes computed at compile time: ";
+    print_array(kPrimes);
+
     ArrayTheSteadfast<int, 3> arr2(42);
     std::cout << "Array with all elements 42: ";
     print_array(arr2);
@@ -289,9 +353,415 @@ void test_array_functionality() {
     arr_cr[1] = ConstructReporter("Array Second");
 }
 
+void test_allocator_functionality() {
+    std::cout << "\n=== VectorTheSerene with Memory Resources ===\n";
+    {
+        ArenaTheFrugal &arena = thread_arena();
+        {
+            pmr::VectorTheSerene<int> v(&arena);
+            for (int i = 0; i < 40; ++i) {
+                v.push_back(i);
+            }
+            // Like std::pmr::vector, a plain copy goes to the default
+            // resource, so the arena has to be passed explicitly
+            pmr::VectorTheSerene<int> copy(v, &arena);
+            std::cout << "Arena vector: ";
+            print_vector(copy);
+            std::cout << "Plain copy uses the arena: "
+                      << (pmr::VectorTheSerene<int>(v)
+                                      .get_allocator()
+                                      .resource() == &arena
+                              ? "true"
+                              : "false")
+                      << std::endl;
+        }
+        std::cout << "Arena bytes before reset: " << arena.bytes_allocated()
+                  << std::endl;
+        arena.reset();
+        std::cout << "Arena bytes after reset: " << arena.bytes_allocated()
+                  << std::endl;
+    }
+    {
+        PoolTheTidy pool;
+        pmr::VectorTheSerene<pmr::VectorTheSerene<int>> rows(&pool);
+        for (int i = 0; i < 3; ++i) {
+            rows.emplace_back();
+            for (int j = 0; j <= i; ++j) {
+                rows.back().push_back(j);
+            }
+        }
+        std::cout << "Pool vector of vectors:\n";
+        print_vector(rows);
+        std::cout << "Inner vectors use the pool: "
+                  << (rows[2].get_allocator().resource() == &pool ? "true"
+                                                                   : "false")
+                  << std::endl;
+
+        // Different resources don't propagate on move, so the elements are
+        // moved one by one instead
+        std::pmr::monotonic_buffer_resource other;
+        pmr::VectorTheSerene<int> moved(&other);
+        moved = std::move(rows[1]);
+        std::cout << "Moved across resources: ";
+        print_vector(moved);
+    }
+}
+
+void test_small_vector_functionality() {
+    std::cout << "\n=== SmallVectorTheSerene ===\n";
+    SmallVectorTheSerene<std::string, 2> inline_v;
+    inline_v.push_back("inline");
+    inline_v.push_back("too");
+    std::cout << "Inline: ";
+    print_vector(inline_v);
+    std::cout << "Capacity while inline: " << inline_v.capacity() << std::endl;
+
+    SmallVectorTheSerene<std::string, 2> heap_v = {"on", "the", "heap"};
+    std::cout << "Heap capacity: " << heap_v.capacity() << std::endl;
+
+    inline_v.swap(heap_v);
+    std::cout << "After swap - first: ";
+    print_vector(inline_v);
+    std::cout << "After swap - second: ";
+    print_vector(heap_v);
+
+    inline_v.pop_back();
+    inline_v.shrink_to_fit();
+    std::cout << "Back inline after shrink_to_fit, capacity: "
+              << inline_v.capacity() << std::endl;
+
+    auto moved = std::move(heap_v);
+    std::cout << "Moved from inline: ";
+    print_vector(moved);
+    std::cout << "Source size after move: " << heap_v.size() << std::endl;
+}
+
+void test_range_functionality() {
+    std::cout << "\n=== Range insertion ===\n";
+    VectorTheSerene<int> v = {1, 2, 3};
+    std::vector<int> batch = {10, 20, 30};
+    v.append_range(batch);
+    std::cout << "append_range: ";
+    print_vector(v);
+
+    v.insert_range(v.begin() + 1, std::views::iota(100, 103));
+    std::cout << "insert_range of a view: ";
+    print_vector(v);
+
+    v.assign_range(batch | std::views::reverse);
+    std::cout << "assign_range: ";
+    print_vector(v);
+
+    VectorTheSerene<char> buffer;
+    buffer.resize_and_overwrite(16, [](char *data, size_t n) {
+        const char message[] = "received";
+        size_t length = std::min(n, sizeof(message) - 1);
+        std::copy(message, message + length, data);
+        return length;
+    });
+    std::cout << "resize_and_overwrite: ";
+    print_vector(buffer);
+
+    AlignedVectorTheSerene<float> aligned(5, 1.5f);
+    std::cout << "Aligned to " << aligned.alignment << " bytes: "
+              << (reinterpret_cast<uintptr_t>(aligned.data()) % 64 == 0)
+              << ", capacity padded to " << aligned.capacity() << std::endl;
+}
+
+void test_serialization_functionality() {
+    std::cout << "\n=== Serialization ===\n";
+    VectorTheSerene<int> v = {1, 2, 3, 4};
+    auto blob = serene_serialize(v);
+    std::cout << "Blob size: " << blob.size() << " bytes" << std::endl;
+    auto copy = serene_deserialize<VectorTheSerene<int>>(blob.begin(),
+                                                         blob.size());
+    std::cout << "Deserialized: ";
+    print_vector(copy);
+    auto view = serene_view<int>(blob.begin(), blob.size());
+    std::cout << "Viewed in place, last: " << view.back() << std::endl;
+
+    VectorTheSerene<VectorTheSerene<int>> rows = {{1}, {}, {2, 3}};
+    auto rows_blob = serene_serialize(rows);
+    auto rows_view = serene_nested_view<int>(rows_blob.begin(),
+                                             rows_blob.size());
+    std::cout << "Nested rows: " << rows_view.size()
+              << ", last row size: " << rows_view[2].size() << std::endl;
+
+    blob[blob.size() - 1] ^= std::byte{1};
+    try {
+        serene_view<int>(blob.begin(), blob.size());
+    } catch (const SereneFormatError &e) {
+        std::cout << "Corrupted blob: " << e.what() << std::endl;
+    }
+}
+
+void test_parallel_functionality() {
+    std::cout << "\n=== Parallel algorithms ===\n";
+    VectorTheSerene<int> v(1 << 20, 1);
+    std::cout << "Threads: " << default_thread_pool().concurrency()
+              << std::endl;
+    std::cout << "Sum of " << v.size()
+              << " ones: " << parallel_reduce(v, int64_t(0)) << std::endl;
+
+    parallel_for(0, v.size(), [&v](size_t i) { v[i] = int(i % 1000); });
+    parallel_transform(v, v.begin(), [](int x) { return 999 - x; });
+    parallel_sort(v);
+    std::cout << "Sorted: " << std::is_sorted(v.begin(), v.end())
+              << ", front: " << v.front() << ", back: " << v.back()
+              << std::endl;
+
+    ArrayTheSteadfast<int, 8> a;
+    parallel_fill(a, 7, {nullptr, 2});
+    std::cout << "Filled array: ";
+    print_array(a);
+
+    VectorTheSerene<int> copy(a.size(), 0);
+    parallel_copy(a, copy.begin());
+    std::cout << "Copied: ";
+    print_vector(copy);
+
+    parallel_resize(copy, 1 << 20, 3);
+    std::cout << "Resized to " << copy.size() << ", back: " << copy.back()
+              << ", sum: " << parallel_reduce(copy, int64_t(0)) << std::endl;
+}
+
+void test_soa_functionality() {
+    std::cout << "\n=== Structure of arrays ===\n";
+    SoaVectorTheSerene<int, double, std::string> items;
+    items.push_back(1, 2.5, "apple");
+    items.push_back(2, 0.75, "pear");
+    items.emplace_back(3, 4.0, "plum");
+
+    for (auto [id, price, name] : items) {
+        std::cout << id << " " << name << " " << price << std::endl;
+    }
+
+    for (double &price : items.column<1>()) {
+        price *= 2;
+    }
+    std::cout << "Doubled prices: ";
+    for (double price : items.column<1>()) {
+        std::cout << price << " ";
+    }
+    std::cout << std::endl;
+
+    auto [id, price, name] = items[2];
+    name = "plums";
+    std::cout << "Row 2 after rename: " << items.get<2>(2) << std::endl;
+    std::cout << "Size: " << items.size()
+              << ", capacity: " << items.capacity() << std::endl;
+}
+
+void test_concurrent_functionality() {
+    std::cout << "\n=== Concurrent appends ===\n";
+    // A stress run: build with ENABLE_TSan to check it for data races
+    constexpr int threads = 8;
+    constexpr int per_thread = 20000;
+    ConcurrentVectorTheSerene<int> v;
+    const int &first = v[v.emplace_back(-1)];
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&v, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    size_t index = v.push_back(t * per_thread + i);
+                    if (v[index] != t * per_thread + i) {
+                        std::cout << "Wrong element at " << index
+                                  << std::endl;
+                    }
+                }
+            });
+        }
+        // A reader racing with the writers
+        workers.emplace_back([&v] {
+            for (int round = 0; round < 50; ++round) {
+                auto prefix = v.snapshot();
+                if (prefix.front() != -1) {
+                    std::cout << "Broken snapshot" << std::endl;
+                }
+            }
+        });
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+    auto all = v.snapshot();
+    std::sort(all.begin(), all.end());
+    bool complete = all.size() == size_t(threads * per_thread + 1);
+    for (size_t i = 1; complete && i < all.size(); ++i) {
+        complete = all[i] == int(i - 1);
+    }
+    std::cout << "Appended from " << threads << " threads: " << v.size()
+              << ", all present: " << complete
+              << ", first element still in place: " << (first == -1)
+              << std::endl;
+}
+
+void test_segmented_functionality() {
+    std::cout << "\n=== Segmented vector ===\n";
+    SegmentedVectorTheSerene<int> v = {3, 4};
+    const int *three = &v.front();
+    for (int i = 5; i < 1000; ++i) {
+        v.push_back(i);
+    }
+    v.push_front(2);
+    v.push_front(1);
+    std::cout << "Size: " << v.size() << ", front: " << v.front()
+              << ", back: " << v.back() << ", v[500]: " << v[500]
+              << std::endl;
+    std::cout << "Address of 3 unchanged after growing: "
+              << (three == &v[2]) << std::endl;
+    v.pop_front();
+    v.pop_back();
+    std::cout << "After popping both ends, first 5: ";
+    for (int item : v | std::views::take(5)) {
+        std::cout << item << " ";
+    }
+    std::cout << std::endl;
+}
+
+void test_flat_functionality() {
+    std::cout << "\n=== Flat set and map ===\n";
+    FlatSetTheSerene<int> set = {5, 1, 4, 1, 3};
+    set.insert(std::vector<int>{9, 2, 4, 7});
+    std::cout << "Set: ";
+    print_vector(set);
+    std::cout << "Contains 7: " << set.contains(7)
+              << ", contains 6: " << set.contains(6)
+              << ", lower_bound(6): " << *set.lower_bound(6) << std::endl;
+
+    FlatSetTheSerene<int, std::less<int>, FlatLayout::eytzinger> frozen(
+        set.keys());
+    std::cout << "Eytzinger upper_bound(4): " << *frozen.upper_bound(4)
+              << ", find(8) is end: " << (frozen.find(8) == frozen.end())
+              << std::endl;
+
+    FlatMapTheSerene<std::string, int> ages = {{"carol", 35}, {"alice", 30}};
+    ages["bob"] = 25;
+    ages.insert_or_assign("alice", 31);
+    ages.insert(std::vector<std::pair<std::string, int>>{{"dave", 40},
+                                                         {"bob", 99}});
+    std::cout << "Map: ";
+    print_vector(ages);
+    std::cout << "Sum of values: "
+              << std::accumulate(ages.values().begin(), ages.values().end(),
+                                 0)
+              << ", at(\"dave\"): " << ages.at("dave") << std::endl;
+    ages.erase("carol");
+    std::cout << "After erasing carol, size: " << ages.size() << std::endl;
+}
+
+void test_hash_map_functionality() {
+    std::cout << "\n=== Hash map ===\n";
+    HashMapTheSerene<std::string, int> symbols = {{"main", 1}, {"printf", 2}};
+    symbols.reserve(1000);
+    std::cout << "Capacity after reserve(1000): " << symbols.capacity()
+              << std::endl;
+    for (int i = 0; i < 1000; ++i) {
+        symbols["sym" + std::to_string(i)] = i;
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        symbols.erase("sym" + std::to_string(i));
+    }
+    std::cout << "Size: " << symbols.size()
+              << ", load factor: " << symbols.load_factor()
+              << ", contains sym2: " << symbols.contains("sym2")
+              << ", sym3: " << symbols.at("sym3")
+              << ", printf: " << symbols.find("printf")->second << std::endl;
+
+    // Values copied from the map itself, while inserting them grows it
+    HashMapTheSerene<int, std::string> names;
+    names.try_emplace(0, "a name too long for the small string buffer");
+    for (int i = 1; i < 100; ++i) {
+        names.try_emplace(i, names.at(i - 1));
+    }
+    bool all_copied = true;
+    for (int i = 0; i < 100; ++i) {
+        all_copied = all_copied && names.at(i) == names.at(0);
+    }
+    std::cout << "Copied from itself across rehashes up to capacity "
+              << names.capacity() << ": " << all_copied << std::endl;
+}
+
+void test_static_vector_functionality() {
+    std::cout << "\n=== Static vector ===\n";
+    StaticVectorTheSerene<int, 8> v = {1, 2, 4};
+    v.insert(v.begin() + 2, 3);
+    v.emplace_back(5);
+    v.erase(v.begin());
+    std::cout << "Contents: ";
+    print_vector(v);
+    std::cout << "Size: " << v.size() << ", capacity: " << v.capacity()
+              << ", trivially copyable: "
+              << std::is_trivially_copyable_v<decltype(v)> << std::endl;
+    while (v.try_emplace_back(0) != nullptr) {
+    }
+    try {
+        v.push_back(6);
+    } catch (const std::length_error &e) {
+        std::cout << "Full at " << v.size() << ": " << e.what() << std::endl;
+    }
+}
+
+void test_ring_functionality() {
+    std::cout << "\n=== Ring ===\n";
+    RingTheSerene<int> queue;
+    for (int i = 0; i < 16; ++i) {
+        queue.push_back(i);
+    }
+    for (int i = 0; i < 10; ++i) {
+        queue.pop_front();
+    }
+    // Wraps around the end of the 16 slots instead of growing
+    for (int i = 16; i < 24; ++i) {
+        queue.push_back(i);
+    }
+    auto [first, second] = queue.segments();
+    std::cout << "Capacity: " << queue.capacity() << ", segments of "
+              << first.size() << " and " << second.size() << ": ";
+    print_vector(queue);
+    queue.pop_front(first.size());
+    std::cout << "After dropping the first segment: ";
+    print_vector(queue);
+
+    RingTheSerene<double> window(4, RingMode::overwrite_oldest);
+    for (int i = 1; i <= 10; ++i) {
+        window.push_back(i * 0.5);
+    }
+    std::cout << "Last 4 samples: ";
+    print_vector(window);
+
+    // Pushing an element of a full ring copies it before it moves or drops
+    RingTheSerene<std::string> words(2, RingMode::grow);
+    words.push_back("alpha");
+    words.push_back("beta");
+    words.push_back(words.front());
+    words.push_front(words.back());
+    std::cout << "Grown from its own elements: ";
+    print_vector(words);
+    RingTheSerene<std::string> last(2, RingMode::overwrite_oldest);
+    last.push_back("alpha");
+    last.push_back("beta");
+    last.push_back(last.front());
+    std::cout << "Overwritten with its own oldest: ";
+    print_vector(last);
+}
+
 int main() {
     test_vector_functionality();
     test_array_functionality();
+    test_allocator_functionality();
+    test_small_vector_functionality();
+    test_range_functionality();
+    test_serialization_functionality();
+    test_parallel_functionality();
+    test_soa_functionality();
+    test_concurrent_functionality();
+    test_segmented_functionality();
+    test_flat_functionality();
+    test_hash_map_functionality();
+    test_static_vector_functionality();
+    test_ring_functionality();
 
     std::cout << "\n=== Nested Containers Tests ===\n";
     VectorTheSerene<ArrayTheSteadfast<int, 3>> v_of_a;